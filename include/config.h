@@ -1,5 +1,8 @@
 #pragma once
 
+#include "election_algorithm.h"
+#include "placement.h"
+#include "unique_ids.h"
 #include "presenters/presenter.h"
 
 #include <spdlog/spdlog.h>
@@ -10,7 +13,29 @@ struct Config {
     std::string config_file{""};
     unsigned int number_of_elections{0};
     unsigned int after_election_sleeptime{5000};
+    bool closed_loop{false};
     unsigned int worker_sleeptime{500};
+    size_t mailbox_capacity{64};
+    size_t batch_limit{64};
+    unsigned int worker_spin_limit{0};
+    bool use_tasks{false};
+    bool use_shards{false};
+    size_t task_threads{0};
+    size_t stack_size{0};
+    unsigned int stop_deadline{5000};
+    Placement placement{Placement::none};
+    size_t sub_ring_size{0};
+    ElectionAlgorithm election_algorithm{ElectionAlgorithm::chang_roberts};
+    IdLayout id_layout{IdLayout::random};
+    size_t number_of_initiators{1};
+    size_t segment_of{0};
+    size_t segment_start{0};
+    std::string listen_endpoint{""};
+    std::string next_endpoint{""};
+    bool simulate{false};
+    uint64_t seed{0};
+    unsigned int link_latency{100};
+    unsigned int link_jitter{0};
     bool logging_enabled{false};
     std::string log_file_name{""};
     bool log_date{false};
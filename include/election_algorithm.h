@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+// The algorithm with which the Workers of a Ring elect their leader
+enum class ElectionAlgorithm {
+    // Chang and Roberts: proposals only travel to the next Worker,
+    // O(n²) Messages in the worst case, when the ids ascend against the ring
+    chang_roberts,
+    // Hirschberg and Sinclair: candidates probe both neighbourhoods
+    // of doubling distances, O(n log n) Messages in any case
+    hirschberg_sinclair,
+    // Peterson, Dolev, Klawe and Rodeh: active Workers only travel along the ring
+    // and compare the ids of the two active Workers before them,
+    // at least half of them become relays per phase, O(n log n) Messages in any case
+    peterson
+};
+
+// The name of the ElectionAlgorithm, as it's configured
+std::string to_string(ElectionAlgorithm election_algorithm);
+
+// Parses the name of an ElectionAlgorithm, returns false if there is none of it
+bool election_algorithm_from_string(
+    const std::string& name, 
+    ElectionAlgorithm& election_algorithm
+);
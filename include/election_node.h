@@ -0,0 +1,84 @@
+#pragma once
+
+#include "election_algorithm.h"
+#include "messages.h"
+#include "presenters/presenter.h"
+
+#include <cstdint>
+
+// What a node of a Ring knows about the elections,
+// kept by a Worker and for every node of a Simulation.
+struct ElectionState {
+    unsigned int id{0};
+    // the newest election the node knows of,
+    // only its Messages are handled and those the node sends are of it
+    uint16_t epoch{0};
+    bool is_leader{false};
+    bool participates_in_election{false};
+    // of a Hirschberg-Sinclair or a Peterson election, while the node is active
+    bool is_candidate{false};
+    uint8_t phase{0};
+    unsigned int number_of_replies{0};
+    // of a Peterson election, the id for which the node is active
+    // and the one the active node before it has sent
+    unsigned int candidate_id{0};
+    unsigned int first_candidate_id{0};
+    // the leader the node has learned about in its epoch, 0 while there is none
+    unsigned int leader_id{0};
+};
+
+// The election logic of the nodes of a Ring, which elect their leader
+// with Chang and Roberts or Peterson only through the node after them
+// or with Hirschberg and Sinclair through the nodes on both of their sides.
+// It acts upon the ElectionState it's given,
+// so a Worker runs it on its own state and a Simulation on that of any of its nodes.
+// Where the Messages go and what a finished election leads to is up to the subclass.
+class ElectionNode {
+  protected:
+    ElectionAlgorithm election_algorithm;
+    Presenter* presenter{nullptr};
+
+    explicit ElectionNode(ElectionAlgorithm election_algorithm)
+    : election_algorithm{election_algorithm}
+    {}
+
+    virtual ~ElectionNode() = default;
+
+    // A Message of a newer election, or a StandIn for it, abandons the current one,
+    // so elections may overlap without one corrupting the other.
+    // Returns false for a Message of an older election, which is to be dropped.
+    bool enter_epoch(ElectionState& node, const Message& message);
+
+    // Acts upon a StartElection or a Message of the election algorithms.
+    void act_upon_election_message(ElectionState& node, const Message& message);
+
+    // Sends the Message to the node after or before the given one.
+    virtual void send_to_neighbour_of(ElectionState& node, const Message& message) = 0;
+    virtual void send_to_predecessor_of(ElectionState& node, const Message& message) = 0;
+
+    // Called once the Elected Message of the node has gone around the Ring.
+    virtual void finish_election(ElectionState& node) = 0;
+
+    // If the node's ring is a level of a hierarchical Ring,
+    // whose leader is announced down to the leader of the ring,
+    // which passes it around the ring.
+    virtual bool has_level_above() const;
+
+  private:
+    void start_election(ElectionState& node);
+    void participate_in_election(ElectionState& node, const Message& proposal);
+    void forward_election_proposal(ElectionState& node, const Message& proposal);
+    void be_elected(ElectionState& node);
+    void propose_oneself(ElectionState& node);
+    void end_election(ElectionState& node, const Message& elected);
+
+    void join_probing(ElectionState& node);
+    void send_probes(ElectionState& node);
+    void handle_probe(ElectionState& node, const Message& probe);
+    void handle_reply(ElectionState& node, const Message& reply);
+
+    void join_peterson_election(ElectionState& node);
+    void handle_candidate(ElectionState& node, const Message& candidate);
+    void handle_previous_candidate(ElectionState& node, const Message& previous_candidate);
+    void relay(ElectionState& node, const Message& message);
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Futex-style waiting on and waking of a 32 bit atomic word.
+// On Linux these are direct futex system calls,
+// elsewhere waiting falls back to polling.
+// Spurious wakeups are possible, callers always need to recheck the word.
+
+// Blocks while the word holds the expected value, until it is woken.
+void futex_wait(std::atomic<uint32_t>& word, uint32_t expected);
+
+// Blocks while the word holds the expected value, 
+// until it is woken or the timeout has elapsed.
+void futex_wait_for(
+    std::atomic<uint32_t>& word, 
+    uint32_t expected, 
+    std::chrono::nanoseconds timeout
+);
+
+// Wakes one thread waiting on the word.
+void futex_wake_one(std::atomic<uint32_t>& word);
+
+// Wakes all threads waiting on the word.
+void futex_wake_all(std::atomic<uint32_t>& word);
+
+// Like futex_wait_for and futex_wake_all,
+// but for a word in memory shared between processes.
+void futex_wait_for_shared(
+    std::atomic<uint32_t>& word, 
+    uint32_t expected, 
+    std::chrono::nanoseconds timeout
+);
+void futex_wake_all_shared(std::atomic<uint32_t>& word);
+
+// Tells the CPU that the calling thread spins on a word,
+// meant for polling briefly before waiting on it.
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
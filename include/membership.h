@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Worker; // a forward declaration of Worker as member of a Ring
+
+// How a version of a Membership differs from the one before
+struct MembershipChange {
+    bool is_insertion{false};
+    // the position of the removed or inserted Worker
+    unsigned int position{0};
+    Worker* worker{nullptr};
+};
+
+// An immutable version of the Workers in a Ring, ordered by their positions.
+// The versions don't refer to each other, so each one is freed on its own.
+class Membership {
+  private:
+    std::vector<Worker*> workers;
+
+    friend class SharedMembership;
+
+  public:
+    const uint64_t version;
+
+    Membership(std::vector<Worker*> workers, uint64_t version = 0);
+
+    size_t size() const;
+
+    // The Worker at the position, counted around the Ring
+    Worker* at(unsigned int position) const;
+};
+
+// The current Membership of a Ring, shared by all of its Workers.
+// A change publishes a new version and leaves the old ones untouched,
+// so the Workers keep reading the version they hold without any lock
+// and only compare its version to the current one;
+// a version is freed as soon as no Worker holds it anymore.
+// Only the changes are logged, indexed by the version they lead to,
+// so a Worker holding an older version follows them to the newest
+// and adjusts its own position per change.
+class SharedMembership {
+  private:
+    std::shared_ptr<const Membership> current;
+    std::atomic<uint64_t> current_version{0};
+    std::vector<MembershipChange> changes{}; // the change to version v at v - 1
+    std::mutex membership_mtx; // serializes the changes
+
+    void publish(std::vector<Worker*> workers, MembershipChange change);
+
+  public:
+    explicit SharedMembership(std::vector<Worker*> workers);
+
+    // The current version, without a lock
+    uint64_t get_version() const;
+
+    // The current Membership
+    std::shared_ptr<const Membership> get();
+
+    // The current Membership, while the changes since the version
+    // are appended to the given ones in order
+    std::shared_ptr<const Membership> get_since(
+        uint64_t version, 
+        std::vector<MembershipChange>& changes
+    );
+
+    // Publishes a version without the Worker, unless it isn't a member.
+    // Returns if it was removed.
+    bool remove(Worker* worker);
+
+    // Publishes a version with the Worker at the position,
+    // unless it's already a member. Returns if it was inserted.
+    bool insert(unsigned int position, Worker* worker);
+};
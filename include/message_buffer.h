@@ -1,39 +1,93 @@
 #pragma once
 
 #include "messages.h"
+#include "message_queue.h"
 
-#include <condition_variable>
-#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
 
-// A Message Buffer, which holds at most one element, 
-// meant for Communication between Workers.
+// Identifies an assigned Message in a Message Buffer,
+// meant to check later if the Message has been taken.
+using DeliveryTicket = uint64_t;
+
+// A Message Buffer, meant for Communication between Workers.
+// With a capacity of 1 it holds at most one element (single-slot rendezvous), 
+// with a larger capacity it is a lock-free Queue for multiple producers.
 class MessageBuffer {
   private:
-    Message* message;
-    bool message_assigned{false};
-    bool message_is_taken{}; // similar to not message_assigned but meant for assign_sync
-    std::mutex buffer_mtx, rendezvous_mtx, assign_and_wait_mtx;
-    std::condition_variable message_takable;    // if there is a message to be taken
-    std::condition_variable message_taken;      // if the message is taken (for assign_and_wait)
-    std::condition_variable message_assignable; // if a message can be assigned
+    std::unique_ptr<MessageQueue> queue; // only used with a capacity above 1
+    const unsigned int spin_limit; // polls of the empty slot before waiting
+
+    // The single slot's whole synchronization lives in one atomic word:
+    //   bits 0-1 ... if the slot is empty, claimed by an assigning thread or full
+    //   bit 2    ... if any thread waits on the word
+    //   the rest ... the number of takes so far (for assign_and_wait)
+    std::atomic<uint32_t> state{0};
+    Message message;
+
+    bool claim_slot(
+        uint32_t& observed_state, 
+        std::chrono::steady_clock::time_point deadline
+    );
+    uint32_t fill_slot(const Message& message, uint32_t observed_state);
+    void wait_on_state(uint32_t observed_state);
+    void wait_on_state_until(
+        uint32_t observed_state, 
+        std::chrono::steady_clock::time_point deadline
+    );
+    void publish_state(uint32_t& observed_state, uint32_t new_state);
 
   public:
+    // take polls the empty Buffer spin_limit times before it blocks,
+    // unless there is only a single core.
+    MessageBuffer(size_t capacity = 1, unsigned int spin_limit = 0);
+
     // Assigns a a given Message to the Buffer.
     // Blocks until the Message has been taken or it times out.
     // Waittime is in milliseconds.
     // If it times out, it returns false otherwise true
-    bool assign_and_wait(Message* message, unsigned int waittime);
+    bool assign_and_wait(const Message& message, unsigned int waittime);
 
     // Assigns a a given Message to the Buffer.
     // Blocks when the previously assigned Message  
     //   hasn't been taken yet, until it is taken.
-    void assign(Message* message);
+    // With a Queue it only blocks while the Queue is full.
+    void assign(const Message& message);
+
+    // Assigns a given Message to the Buffer, 
+    // when there is space for it before the deadline.
+    // Returns if the Message could be assigned; 
+    // the ticket is set to identify it for is_taken.
+    bool assign_until(
+        const Message& message, 
+        std::chrono::steady_clock::time_point deadline, 
+        DeliveryTicket& ticket
+    );
+
+    // Returns if the Message identified by the ticket has been taken
+    bool is_taken(DeliveryTicket ticket);
 
     // Returns the Message the Buffer holds;
     // Blocks when there is no Message assigned after 
     //   the last one has been taken, until there is.
-    Message* take();
+    Message take();
+
+    // Takes all Messages the Buffer holds, but at most limit many,
+    // appends them to the given vector in their order and returns their number;
+    // Blocks when there is no Message assigned, until there is.
+    // The single-slot Buffer always returns exactly one Message.
+    size_t take_all(std::vector<Message>& messages, size_t limit);
+
+    // Takes the Messages the Buffer holds like take_all,
+    // but doesn't block when there is none and returns 0 instead.
+    size_t try_take_all(std::vector<Message>& messages, size_t limit);
 
     // Returns if the Buffer has no Message
     bool is_empty();
+
+    // Returns how many Messages the Buffer can hold
+    size_t get_capacity() const;
 };
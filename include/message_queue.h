@@ -0,0 +1,107 @@
+#pragma once
+
+#include "messages.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// The assumed size of a cache line.
+// Values written by different threads are kept apart by it.
+constexpr size_t cache_line_size{64};
+
+// The smallest power of 2 which is at least the number, 1 for 0;
+// the capacities of the lock-free Queues and Channels are rounded up to it.
+inline size_t round_up_to_power_of_2(size_t number) {
+    size_t power{1};
+    while (power < number) {
+        power <<= 1;
+    }
+    return power;
+}
+
+// A bounded, lock-free Queue of Messages for multiple producers
+// and a single consumer, meant as the mailbox of a Worker.
+// Only the consumer parks, when the Queue is empty,
+// after polling it up to its spin limit;
+// producers facing a full Queue back off by yielding.
+class MessageQueue {
+  private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        Message message;
+    };
+
+    const size_t capacity; // always a power of 2
+    const unsigned int spin_limit; // polls of the empty Queue before parking
+    std::unique_ptr<Cell[]> cells;
+
+    alignas(cache_line_size) std::atomic<size_t> enqueue_position{0};
+    alignas(cache_line_size) std::atomic<size_t> dequeue_position{0};
+
+    // Parking of the consumer when the Queue is empty, a futex word
+    alignas(cache_line_size) std::atomic<uint32_t> consumer_parked{0};
+
+    // Waiting of producers for their Message to be taken (for push_and_wait),
+    // the signal is a futex word changed after takes when there are waiters
+    alignas(cache_line_size) std::atomic<uint32_t> take_waiters{0};
+    std::atomic<uint32_t> take_signal{0};
+
+    bool try_push(const Message& message, size_t& position);
+    bool try_pop(Message& message);
+    Message pop_or_park();
+    void wake_consumer();
+    void wake_take_waiters();
+
+  public:
+    // The capacity is rounded up to the next power of 2.
+    // The consumer polls the empty Queue spin_limit times before it parks.
+    MessageQueue(size_t capacity, unsigned int spin_limit = 0);
+
+    // Pushes a given Message into the Queue.
+    // Backs off while the Queue is full, until there is space.
+    void push(const Message& message);
+
+    // Pushes a given Message into the Queue.
+    // Blocks until the Message has been taken or it times out.
+    // Waittime is in milliseconds.
+    // If it times out, it returns false otherwise true
+    bool push_and_wait(const Message& message, unsigned int waittime);
+
+    // Pushes a given Message into the Queue, 
+    // when there is space for it before the deadline.
+    // Returns if the Message could be pushed and sets its position.
+    bool push_until(
+        const Message& message, 
+        std::chrono::steady_clock::time_point deadline, 
+        size_t& position
+    );
+
+    // Returns if the Message pushed to the given position has been taken
+    bool is_taken(size_t position) const;
+
+    // Returns the oldest Message in the Queue;
+    // Spins and then parks when the Queue is empty, until there is a Message.
+    // Must only be called by one thread at a time.
+    Message take();
+
+    // Takes all Messages currently in the Queue, but at most limit many,
+    // appends them to the given vector in their order and returns their number;
+    // Spins and then parks when the Queue is empty, 
+    //   until there is at least one Message.
+    // Must only be called by one thread at a time.
+    size_t take_all(std::vector<Message>& messages, size_t limit);
+
+    // Takes the Messages currently in the Queue like take_all,
+    // but doesn't park when the Queue is empty and returns 0 instead.
+    // Must only be called by one thread at a time.
+    size_t try_take_all(std::vector<Message>& messages, size_t limit);
+
+    // Returns if the Queue holds no Message
+    bool is_empty() const;
+
+    size_t get_capacity() const;
+};
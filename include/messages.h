@@ -1,11 +1,17 @@
 #pragma once
 
+#include "object_pool.h"
+
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #define FMT_HEADER_ONLY
 #include <fmt/core.h>
 
-// The possible Types of Messages a Message-Object can represent.
-enum class MessageType {
+// The possible Types of Messages a Message can represent.
+enum class MessageType: uint8_t {
     NoMessage,
     LogMessage,
     Stop,
@@ -13,133 +19,243 @@ enum class MessageType {
     ElectionProposal,
     Elected,
     DeadWorker,
-    NewWorker
+    NewWorker,
+    Probe,
+    Reply,
+    Candidate,
+    PreviousCandidate,
+    StandIn
 };
 
+class Worker; // a forward declaration of Worker for NewWorker
+
 // A Message, meant to represent Information for Communication between Workers.
-// It is not instantiable and only meant as a common Base Class.
+// It's a compact and trivially copyable value, which is passed by value,
+// so sending it never allocates.
+// Which of its fields hold a value depends on its type.
 struct Message {
-    // The Type of the Message object
-    const MessageType type;
-
-    // An easier form of static casting for Message objects.
-    // Meant to be used to cast to the appropriate Subclass annotated by 'type'.
-    template<typename T>
-    T* cast_to() {
-        return static_cast<T*>(this);
-    }
+    // The Type of the Message
+    MessageType type{MessageType::NoMessage};
 
-    virtual explicit operator std::string() const {
-        return "Non-Specified Message";
-    }
+    // The election the Message is part of, counted up with each election
+    // and compared with wrap-around by is_older_epoch
+    //   (StartElection, StandIn and the Messages of the election algorithms)
+    uint16_t epoch{0};
 
-    virtual ~Message() = default;
+    union {
+        // the id of the proposed or elected Worker, of the candidate
+        // or of the leader stood in for
+        //   (ElectionProposal, Elected, Probe, Reply, Candidate, PreviousCandidate, StandIn)
+        uint32_t id{0};
+        // the position of the dead or new Worker
+        //   (DeadWorker, NewWorker)
+        uint32_t position;
+        // the number of characters of the content (LogMessage)
+        uint32_t content_size;
+    };
 
-  protected:
-    Message(MessageType type): type{type} {}
-};
+    union {
+        // the newly added Worker (NewWorker)
+        Worker* worker{nullptr};
+        // the characters of the content for log/output, 
+        // owned by the Message and not terminated (LogMessage)
+        char* content;
+        // the candidate's phase, the hops the Probe has taken so far
+        // and if it travels to the predecessors (Probe, Reply, and only
+        // the phase for Candidate, PreviousCandidate)
+        struct {
+            uint32_t hops;
+            uint8_t phase;
+            bool is_backwards;
+        } probing;
+    };
 
-// A Message meant to represent nothing.
-struct NoMessage: Message {
-    NoMessage(): Message(MessageType::NoMessage) {}
+    Message() = default;
+    explicit Message(MessageType type): type{type} {}
 
-    explicit operator std::string() const override {
-        return "No Message";
+    // A Message meant to represent nothing.
+    static Message no_message() {
+        return {};
     }
-};
-
-// A Message which holds content for log/output.
-struct LogMessage: Message {
-    const std::string content;
 
-    LogMessage(
-        std::string content
-    ): Message(MessageType::LogMessage), 
-       content{content} 
-    {}
-
-    explicit operator std::string() const override {
-        return fmt::format("Log Message containing '{}'", content);
+    // A Message which holds content for log/output.
+    // The content is the only part of a Message which is allocated,
+    // its characters are copied into a buffer of the Buffer Pool
+    // and freed by dispose; only a content longer than its largest buffers
+    // is taken from the heap.
+    static Message log_message(std::string_view content) {
+        Message message{MessageType::LogMessage};
+        message.content_size = (uint32_t)content.size();
+        message.content = 
+            content.size() <= BufferPool::max_capacity
+            ? BufferPool::create(content.size())
+            : new char[content.size()];
+        std::memcpy(message.content, content.data(), content.size());
+        return message;
     }
-};
 
-// The Signal to stop
-struct Stop: Message {
-    Stop(): Message(MessageType::Stop) {}
+    // The Signal to stop
+    static Message stop() {
+        return Message{MessageType::Stop};
+    }
 
-    explicit operator std::string() const override {
-        return "Stop";
+    // The Signal to start a new election in the epoch
+    static Message start_election(uint16_t epoch = 0) {
+        Message message{MessageType::StartElection};
+        message.epoch = epoch;
+        return message;
     }
-};
 
-// The Signal to start a new election
-struct StartElection: Message {
-    StartElection(): Message(MessageType::StartElection) {}
+    // A proposal for the election containing the id of the proposed leader.
+    static Message election_proposal(unsigned int id) {
+        Message message{MessageType::ElectionProposal};
+        message.id = id;
+        return message;
+    }
 
-    explicit operator std::string() const override {
-        return "Start Election";
+    // A message containing the id of the newly elected leader.
+    static Message elected(unsigned int id) {
+        Message message{MessageType::Elected};
+        message.id = id;
+        return message;
     }
-};
 
-// A proposal for the election containing the id of the proposed leader.
-struct ElectionProposal: Message {
-    const unsigned int id;
+    // A message containing the position of a worker marked dead which needs to be removed.
+    static Message dead_worker(unsigned int position) {
+        Message message{MessageType::DeadWorker};
+        message.position = position;
+        return message;
+    }
 
-    ElectionProposal(
-        unsigned int id
-    ): Message(MessageType::ElectionProposal), 
-       id{id} 
-    {}
+    // A message containing the position of and pointer to a newly added worker.
+    static Message new_worker(unsigned int position, Worker* worker) {
+        Message message{MessageType::NewWorker};
+        message.position = position;
+        message.worker = worker;
+        return message;
+    }
 
-    explicit operator std::string() const override {
-        return fmt::format("Election Propsal for {}", id);
+    // A probe of a candidate in a Hirschberg-Sinclair election,
+    // which travels up to 2^phase hops in one direction.
+    static Message probe(unsigned int id, uint8_t phase, uint32_t hops, bool is_backwards) {
+        Message message{MessageType::Probe};
+        message.id = id;
+        message.probing = {hops, phase, is_backwards};
+        return message;
     }
-};
 
-// A message containing the id of the newly elected leader.
-struct Elected: Message {
-    const unsigned int id;
+    // The reply to a probe which has taken all of its hops without being swallowed,
+    // it travels back to the candidate.
+    static Message reply(unsigned int id, uint8_t phase, bool is_backwards) {
+        Message message{MessageType::Reply};
+        message.id = id;
+        message.probing = {0, phase, is_backwards};
+        return message;
+    }
 
-    Elected(unsigned int id): Message(MessageType::Elected), id{id} {}
+    // The candidate of an active Worker in a Peterson election,
+    // for the next active Worker.
+    static Message candidate(unsigned int id, uint8_t phase) {
+        Message message{MessageType::Candidate};
+        message.id = id;
+        message.probing = {0, phase, false};
+        return message;
+    }
 
-    explicit operator std::string() const override {
-        return fmt::format("Worker {} has been elected", id);
+    // The candidate an active Worker got in a Peterson election,
+    // which is passed on to the next active Worker.
+    static Message previous_candidate(unsigned int id, uint8_t phase) {
+        Message message{MessageType::PreviousCandidate};
+        message.id = id;
+        message.probing = {0, phase, false};
+        return message;
     }
-};
 
-// A message containing the position of a worker marked dead which needs to be removed.
-struct DeadWorker: Message {
-    const unsigned int position;
+    // The content for log/output of a LogMessage
+    std::string_view get_content() const {
+        return {content, content_size};
+    }
 
-    DeadWorker(
-        unsigned int position
-    ): Message(MessageType::DeadWorker), 
-       position{position} 
-    {}
+    // The Signal for a delegate of a hierarchical Ring to stand in 
+    // for the leader of its ring below in the epoch, by taking on its id.
+    static Message stand_in(unsigned int id, uint16_t epoch) {
+        Message message{MessageType::StandIn};
+        message.id = id;
+        message.epoch = epoch;
+        return message;
+    }
 
-    explicit operator std::string() const override {
-        return fmt::format("Worker on position {} is marked dead", position);
+    // Frees what the Message has allocated, which is only a LogMessage's content.
+    // Needs to be called once by whoever consumes or drops the Message.
+    void dispose() {
+        if (type == MessageType::LogMessage && content) {
+            if (content_size <= BufferPool::max_capacity) {
+                BufferPool::destroy(content, content_size);
+            }
+            else {
+                delete[] content;
+            }
+            content = nullptr;
+        }
     }
-}; 
 
-class Worker; // a forward declaration of Worker for NewWorker
+    explicit operator std::string() const {
+        switch (type) {
+            case MessageType::NoMessage:
+                return "No Message";
+            case MessageType::LogMessage:
+                return fmt::format("Log Message containing '{}'", get_content());
+            case MessageType::Stop:
+                return "Stop";
+            case MessageType::StartElection:
+                return "Start Election";
+            case MessageType::ElectionProposal:
+                return fmt::format("Election Propsal for {}", id);
+            case MessageType::Elected:
+                return fmt::format("Worker {} has been elected", id);
+            case MessageType::DeadWorker:
+                return fmt::format("Worker on position {} is marked dead", position);
+            case MessageType::NewWorker:
+                return fmt::format("There is a new worker on position {}", position);
+            case MessageType::Probe:
+                return fmt::format("Probe of {} in phase {} after {} hops", id, probing.phase, probing.hops);
+            case MessageType::Reply:
+                return fmt::format("Reply to {} in phase {}", id, probing.phase);
+            case MessageType::Candidate:
+                return fmt::format("Candidate {} in phase {}", id, probing.phase);
+            case MessageType::PreviousCandidate:
+                return fmt::format("Previous Candidate {} in phase {}", id, probing.phase);
+            case MessageType::StandIn:
+                return fmt::format("Stand in for {}", id);
+        }
 
-// A message containing the position of and pointer to a newly added worker.
-struct NewWorker: Message {
-    const unsigned int position;
+        return "Non-Specified Message";
+    }
+};
 
-    // can't be constant because it has to be inserted into vectors
-    Worker* worker; 
+// If the epoch is older than the other one,
+// which holds for up to half of all epochs before it, so the epochs may wrap around.
+inline bool is_older_epoch(uint16_t epoch, uint16_t other_epoch) {
+    return (int16_t)(uint16_t)(epoch - other_epoch) < 0;
+}
 
-    NewWorker(
-        unsigned int position,
-        Worker* worker
-    ): Message(MessageType::NewWorker), 
-       position{position},
-       worker{worker}
-    {}
+// If the Message is one of the election algorithms, which is sent in an epoch.
+inline bool is_election_message(const Message& message) {
+    return message.type == MessageType::ElectionProposal
+           ||
+           message.type == MessageType::Elected
+           ||
+           message.type == MessageType::Probe
+           ||
+           message.type == MessageType::Reply
+           ||
+           message.type == MessageType::Candidate
+           ||
+           message.type == MessageType::PreviousCandidate;
+}
 
-    explicit operator std::string() const override {
-        return fmt::format("There is a new worker on position {}", position);
-    }
-};
+static_assert(
+    std::is_trivially_copyable<Message>::value,
+    "a Message needs to be copyable as plain bytes"
+);
+static_assert(sizeof(Message) <= 16, "a Message needs to fit into 16 bytes");
@@ -0,0 +1,308 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+// The Statistics of an Object Pool
+struct PoolStatistics {
+    size_t live_objects{0}; // objects which are currently created
+    size_t high_water_mark{0}; // the most objects which have been created at once
+    size_t cross_thread_frees{0}; // objects destroyed by another thread than their creator
+    size_t reserved_objects{0}; // room for objects which has been taken from the heap
+};
+
+// A process-wide Pool for objects of one type with a free list per thread.
+// Room for objects is taken from the heap in chunks and is never given back,
+// so the memory use stays flat once the Pool has grown to the working set.
+// Free lists are exchanged with a shared list only in batches,
+// so the shared lock is taken at most once per batch
+// even when objects are destroyed by another thread than their creator.
+// A batch is smaller for large objects, so a thread which creates a few of them
+// doesn't reserve much more than it uses.
+template<typename T>
+class ObjectPool {
+  private:
+    struct Block {
+        union {
+            Block* next;
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+        uint32_t creator; // the number of the thread which created the object
+    };
+
+    // A singly-linked list of free Blocks
+    struct FreeList {
+        Block* first{nullptr};
+        size_t size{0};
+
+        void push(Block* block) {
+            block->next = first;
+            first = block;
+            size++;
+        }
+
+        Block* pop() {
+            Block* block{first};
+            first = block->next;
+            size--;
+            return block;
+        }
+
+        // Moves the given number of Blocks into a new list
+        FreeList split(size_t number_of_blocks) {
+            FreeList list{};
+            while (list.size < number_of_blocks) {
+                list.push(pop());
+            }
+            return list;
+        }
+    };
+
+    // up to 64 objects, but not more of them than fit into 16 KiB
+    static constexpr size_t max_batch_bytes{16 * 1024};
+    static constexpr size_t batch_size{
+        std::clamp<size_t>(max_batch_bytes / sizeof(Block), 1, 64)
+    };
+
+    // What all threads share, only accessed under its lock except for the counters
+    struct Shared {
+        std::mutex shared_mtx;
+        std::vector<FreeList> batches{};
+        std::vector<std::unique_ptr<Block[]>> chunks{};
+        size_t reserved_objects{0};
+        std::atomic<uint32_t> number_of_threads{0};
+
+        alignas(64) std::atomic<size_t> live_objects{0};
+        std::atomic<size_t> high_water_mark{0};
+        std::atomic<size_t> cross_thread_frees{0};
+    };
+
+    // The free list of one thread, returned to the shared list when the thread exits
+    struct Cache {
+        Shared& shared;
+        const uint32_t thread_number;
+        FreeList free_blocks{};
+
+        Cache(): shared{get_shared()}, thread_number{shared.number_of_threads++} {}
+
+        ~Cache() {
+            if (free_blocks.size > 0) {
+                std::lock_guard<std::mutex> shared_lck{shared.shared_mtx};
+                shared.batches.push_back(free_blocks);
+            }
+        }
+    };
+
+    static Shared& get_shared() {
+        static Shared shared{};
+        return shared;
+    }
+
+    static Cache& get_cache() {
+        static thread_local Cache cache{};
+        return cache;
+    }
+
+    // Fills the empty free list with a batch from the shared list
+    // or with a new chunk from the heap, if there is no batch.
+    static void refill(Cache& cache) {
+        Shared& shared{cache.shared};
+        std::lock_guard<std::mutex> shared_lck{shared.shared_mtx};
+
+        if (!shared.batches.empty()) {
+            cache.free_blocks = shared.batches.back();
+            shared.batches.pop_back();
+            return;
+        }
+
+        std::unique_ptr<Block[]> chunk{new Block[batch_size]};
+        for (size_t i{0}; i < batch_size; i++) {
+            cache.free_blocks.push(&chunk[i]);
+        }
+        shared.chunks.push_back(std::move(chunk));
+        shared.reserved_objects += batch_size;
+    }
+
+    // Gives a batch back to the shared list, when the free list holds two of them.
+    static void drain(Cache& cache) {
+        if (cache.free_blocks.size >= 2 * batch_size) {
+            FreeList batch{cache.free_blocks.split(batch_size)};
+
+            std::lock_guard<std::mutex> shared_lck{cache.shared.shared_mtx};
+            cache.shared.batches.push_back(batch);
+        }
+    }
+
+  public:
+    ObjectPool() = delete;
+
+    // Creates an object in the Pool from the given arguments.
+    template<typename... Args>
+    static T* create(Args&&... args) {
+        Cache& cache{get_cache()};
+        if (cache.free_blocks.size == 0) {
+            refill(cache);
+        }
+
+        Block* block{cache.free_blocks.pop()};
+        T* object;
+        try {
+            object = new (block->storage) T(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            cache.free_blocks.push(block);
+            throw;
+        }
+        block->creator = cache.thread_number;
+
+        Shared& shared{cache.shared};
+        size_t live_objects{
+            shared.live_objects.fetch_add(1, std::memory_order_relaxed) + 1
+        };
+        size_t high_water_mark{
+            shared.high_water_mark.load(std::memory_order_relaxed)
+        };
+        while (live_objects > high_water_mark
+                &&
+               !shared.high_water_mark.compare_exchange_weak(
+                    high_water_mark,
+                    live_objects,
+                    std::memory_order_relaxed
+               )
+        ) {}
+
+        return object;
+    }
+
+    // Destroys an object created by the Pool, on any thread.
+    static void destroy(T* object) {
+        if (!object) {
+            return;
+        }
+
+        Cache& cache{get_cache()};
+        Block* block{reinterpret_cast<Block*>(object)};
+
+        object->~T();
+
+        if (block->creator != cache.thread_number) {
+            cache.shared.cross_thread_frees.fetch_add(1, std::memory_order_relaxed);
+        }
+        cache.shared.live_objects.fetch_sub(1, std::memory_order_relaxed);
+
+        cache.free_blocks.push(block);
+        drain(cache);
+    }
+
+    static PoolStatistics get_statistics() {
+        Shared& shared{get_shared()};
+        std::lock_guard<std::mutex> shared_lck{shared.shared_mtx};
+
+        return {
+            shared.live_objects.load(std::memory_order_relaxed),
+            shared.high_water_mark.load(std::memory_order_relaxed),
+            shared.cross_thread_frees.load(std::memory_order_relaxed),
+            shared.reserved_objects
+        };
+    }
+};
+
+// A process-wide Pool for character buffers of a few fixed capacities,
+// each size class an Object Pool of its own,
+// so a buffer of any size up to the largest class is taken without the heap;
+// the largest buffers are reserved one at a time.
+class BufferPool {
+  private:
+    // Only the characters, so the Buffer is found from them
+    template<size_t capacity>
+    struct Buffer {
+        char characters[capacity];
+
+        // leaves the characters uninitialized
+        Buffer() {}
+    };
+
+    static constexpr size_t capacities[]{64, 512, 4096, 64 * 1024};
+
+    static size_t get_size_class(size_t size) {
+        size_t size_class{0};
+        while (capacities[size_class] < size) {
+            size_class++;
+        }
+        return size_class;
+    }
+
+  public:
+    static constexpr size_t number_of_size_classes{std::size(capacities)};
+    static constexpr size_t max_capacity{capacities[number_of_size_classes - 1]};
+    static_assert(number_of_size_classes == 4, "each size class has its case");
+
+    BufferPool() = delete;
+
+    // Creates a buffer for at least size characters, 
+    // which mustn't exceed the max capacity.
+    static char* create(size_t size) {
+        switch (get_size_class(size)) {
+            case 0: 
+                return ObjectPool<Buffer<capacities[0]>>::create()->characters;
+            case 1: 
+                return ObjectPool<Buffer<capacities[1]>>::create()->characters;
+            case 2: 
+                return ObjectPool<Buffer<capacities[2]>>::create()->characters;
+            default: 
+                return ObjectPool<Buffer<capacities[3]>>::create()->characters;
+        }
+    }
+
+    // Destroys a buffer created for the size, on any thread.
+    static void destroy(char* buffer, size_t size) {
+        switch (get_size_class(size)) {
+            case 0: 
+                ObjectPool<Buffer<capacities[0]>>::destroy(
+                    reinterpret_cast<Buffer<capacities[0]>*>(buffer)
+                );
+                break;
+            case 1: 
+                ObjectPool<Buffer<capacities[1]>>::destroy(
+                    reinterpret_cast<Buffer<capacities[1]>*>(buffer)
+                );
+                break;
+            case 2: 
+                ObjectPool<Buffer<capacities[2]>>::destroy(
+                    reinterpret_cast<Buffer<capacities[2]>*>(buffer)
+                );
+                break;
+            default: 
+                ObjectPool<Buffer<capacities[3]>>::destroy(
+                    reinterpret_cast<Buffer<capacities[3]>*>(buffer)
+                );
+                break;
+        }
+    }
+
+    // The capacity of the buffers of the size class
+    static size_t get_capacity(size_t size_class) {
+        return capacities[size_class];
+    }
+
+    static PoolStatistics get_statistics(size_t size_class) {
+        switch (size_class) {
+            case 0: 
+                return ObjectPool<Buffer<capacities[0]>>::get_statistics();
+            case 1: 
+                return ObjectPool<Buffer<capacities[1]>>::get_statistics();
+            case 2: 
+                return ObjectPool<Buffer<capacities[2]>>::get_statistics();
+            default: 
+                return ObjectPool<Buffer<capacities[3]>>::get_statistics();
+        }
+    }
+};
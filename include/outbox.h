@@ -0,0 +1,134 @@
+#pragma once
+
+#include "messages.h"
+#include "message_buffer.h"
+#include "object_pool.h"
+#include "sized_thread.h"
+#include "timing_wheel.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+class Worker; // a forward declaration of Worker as receiver of Deliveries
+
+// The outbound path of a Worker.
+// A persistent sender thread assigns the queued Messages in their order
+// to their receivers and tracks their delivery deadlines 
+// on the process-wide Timing Wheel instead of waiting for them to be taken.
+// Receivers which didn't take a Message in time are reported as failed.
+// Deliveries are kept in intrusive lists of pooled nodes,
+// so sending doesn't reach the heap once the pools have grown.
+// Without a sender thread, for Workers run as Tasks, Messages are assigned
+// directly when there is space and the others are retried by flush.
+class Outbox {
+  private:
+    struct Delivery {
+        Worker* receiver;
+        Message message;
+        // until when it may be assigned (only used without a sender thread)
+        std::chrono::steady_clock::time_point deadline;
+        Delivery* next{nullptr};
+    };
+
+    // An assigned Message whose deadline is tracked by the Timing Wheel
+    struct PendingDelivery {
+        Worker* receiver;
+        DeliveryTicket ticket;
+        std::chrono::steady_clock::time_point deadline;
+        TimingWheel::Handle timer{};
+        PendingDelivery* next{nullptr};
+    };
+
+    // the queued Deliveries, oldest first
+    Delivery* first_delivery{nullptr};
+    Delivery* last_delivery{nullptr};
+    // the Delivery the sender thread is assigning right now
+    Delivery* current_delivery{nullptr};
+    // only used under their own lock, oldest first
+    PendingDelivery* first_pending_delivery{nullptr};
+    PendingDelivery* last_pending_delivery{nullptr};
+    std::mutex pending_mtx;
+    std::vector<Worker*> failed_receivers{};
+    // the Messages of the failed Deliveries, which were never assigned,
+    // kept until the call of take_failed_receivers 
+    // after the one which returned their receivers,
+    // so they can be redirected meanwhile
+    std::vector<Delivery> failed_deliveries{};
+    std::vector<Delivery> taken_failed_deliveries{};
+    bool running{false};
+    bool has_sender{false};
+    std::mutex outbox_mtx;
+    std::condition_variable delivery_queued;
+    SizedThread sender;
+
+    void deliver();
+    bool assign_until_stopped(
+        Delivery* delivery, 
+        Worker*& receiver, 
+        std::chrono::steady_clock::time_point& deadline, 
+        DeliveryTicket& ticket
+    );
+    bool try_deliver(
+        Worker* receiver, 
+        const Message& message, 
+        std::chrono::steady_clock::time_point deadline
+    );
+    void queue_delivery(Delivery* delivery);
+    void track_pending_delivery(
+        Worker* receiver, 
+        DeliveryTicket ticket, 
+        std::chrono::steady_clock::time_point deadline
+    );
+    void settle_pending_deliveries();
+    void report_failed_delivery(Worker* receiver, const Message& message);
+    void add_failed_delivery(Worker* receiver, const Message& message);
+    void report_failed_receiver(Worker* receiver);
+    void dispose_failed_deliveries(std::vector<Delivery>& deliveries);
+
+  public:
+    ~Outbox();
+
+    // Starts the sender thread with the stack size in bytes,
+    // 0 is the system's default.
+    void start(size_t stack_size = 0);
+
+    // Starts sending without a sender thread; 
+    // then the Outbox must only be used by one thread at a time.
+    void start_without_sender();
+
+    // Stops the sender thread, which gives up waiting for space 
+    // for its current Delivery, and stops tracking the deadlines of assigned Messages;
+    // Messages which haven't been assigned yet are dropped.
+    void stop();
+
+    // Queues the Message for delivery to the receiver without blocking.
+    // Without a sender thread it's assigned right away, if there is space.
+    void send(Worker* receiver, const Message& message);
+
+    // Retries to assign the queued Messages without a sender thread;
+    // Messages which couldn't be assigned in time are reported as failed.
+    // Returns if there are still Messages queued.
+    bool flush();
+
+    // Sends the Messages for the receiver, which has been removed, 
+    // to the new receiver instead: those there was no space for
+    // since the last but one call of take_failed_receivers 
+    // and the queued ones, in their order.
+    // The Messages assigned to the receiver are left in its mailbox,
+    // even when it didn't take them in time, so a receiver which is 
+    // only slow doesn't handle them besides the new receiver;
+    // a dead receiver's are lost, so delivery is at most once.
+    void redirect(Worker* receiver, Worker* new_receiver);
+
+    // Returns the receivers which failed to take a Message in time
+    // since the last call, in the order of their failures;
+    // their Messages, which weren't redirected until the next call, are dropped then.
+    std::vector<Worker*> take_failed_receivers();
+
+    // Returns the Statistics of the pools of all Outboxes' Deliveries
+    //   and of their pending Deliveries
+    static PoolStatistics get_delivery_pool_statistics();
+    static PoolStatistics get_pending_delivery_pool_statistics();
+};
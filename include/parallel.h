@@ -0,0 +1,37 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Below this many items per thread, splitting up the work doesn't pay off
+constexpr size_t minimal_items_per_thread{10000};
+
+// Calls the function with contiguous ranges [begin, end) covering all items,
+// one range per core, in parallel threads and the calling one;
+// returns when all are done.
+// Few items are handled by the calling thread alone.
+template<typename Function>
+void parallel_for(size_t number_of_items, const Function& function) {
+    size_t number_of_threads{std::min(
+        (size_t)std::max(1u, std::thread::hardware_concurrency()),
+        std::max((size_t)1, number_of_items / minimal_items_per_thread)
+    )};
+
+    std::vector<std::thread> threads{};
+    threads.reserve(number_of_threads - 1);
+
+    for (size_t i{1}; i < number_of_threads; i++) {
+        threads.push_back(std::thread{
+            function,
+            i * number_of_items / number_of_threads,
+            (i + 1) * number_of_items / number_of_threads
+        });
+    }
+    function((size_t)0, number_of_items / number_of_threads);
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// How the threads of the Workers are placed on the CPUs
+enum class Placement {
+    none,    // left to the operating system
+    compact, // neighbouring positions on the same CPU or on CPUs sharing caches
+    scatter  // neighbouring positions on different CPUs, round-robin
+};
+
+// The name of the Placement, as it's configured
+std::string to_string(Placement placement);
+
+// Parses the name of a Placement, returns false if there is none of it
+bool placement_from_string(const std::string& name, Placement& placement);
+
+// The CPUs the process may run on, ordered by their package, their die
+// and their core, so CPUs close in the order share as many caches as possible.
+// It's empty where threads can't be pinned.
+std::vector<int> get_ordered_cpus();
+
+// The CPU out of the ordered CPUs for the thread at the position,
+// or -1 when it's not to be pinned.
+// Compact splits the positions into one contiguous block per CPU.
+int get_cpu_for_position(
+    Placement placement,
+    size_t position,
+    size_t number_of_positions,
+    const std::vector<int>& cpus
+);
+
+// Pins the calling thread to the CPU, threads it starts afterwards inherit it.
+// Returns if it was pinned.
+bool pin_current_thread(int cpu);
@@ -16,7 +16,7 @@ class ConsoleWriter: public Logger {
     void ring_started() override;
     void ring_stopped() override;
 
-    void worker_says(unsigned int worker_id, const std::string& message) override;
+    void worker_says(unsigned int worker_id, std::string_view message) override;
     void worker_starts_election(unsigned int worker_id) override;
     void worker_proposes_itself_in_election(unsigned int worker_id) override;
     void worker_forwards_election_proposal(unsigned int worker_id, unsigned int proposal_id) override;
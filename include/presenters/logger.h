@@ -2,12 +2,23 @@
 
 #include "presenters/presenter.h"
 
-// A Presenter that logs everything with the given logger
+// A Presenter that logs everything with the given logger.
+// Events are only formatted when their level is logged.
 class Logger: public Presenter {
   private:
     std::shared_ptr<spdlog::logger> logger;
     bool is_file_logger;
 
+  protected:
+    // Returns if messages of the given level are logged.
+    // Levels below SPDLOG_ACTIVE_LEVEL (the meson option min_log_level)
+    //   are stripped at compile time.
+    bool logs(spdlog::level::level_enum log_level) const {
+        return static_cast<int>(log_level) >= SPDLOG_ACTIVE_LEVEL 
+                && 
+               logger->should_log(log_level);
+    }
+
   public:
     Logger(
         std::shared_ptr<spdlog::logger> logger, 
@@ -22,7 +33,9 @@ class Logger: public Presenter {
 
     template<typename... Args>
     void log(spdlog::level::level_enum log_level, const Args&... args) {
-        logger->log(log_level, args...);
+        if (logs(log_level)) {
+            logger->log(log_level, args...);
+        }
     }
 
     void log(spdlog::level::level_enum log_level, const std::string& message) override;
@@ -30,15 +43,20 @@ class Logger: public Presenter {
     virtual void ring_created(size_t ring_size) override;
     virtual void ring_starts() override;
     virtual void ring_started() override;
+    virtual void ring_startup_timed(double id_time, double construction_time, double wiring_time, double start_time) override;
     virtual void ring_stops() override;
     virtual void ring_stopped() override;
 
     virtual void worker_created(unsigned int worker_id, unsigned int position) override;
     virtual void worker_started(unsigned int position) override;
+    virtual void workers_placed(const std::string& placement, size_t number_of_cpus) override;
     virtual void worker_stopped(unsigned int position) override;
+    virtual void worker_missed_stop_deadline(unsigned int position) override;
+    virtual void workers_handled_batches(size_t number_of_batches, size_t number_of_messages, size_t largest_batch) override;
+    virtual void object_pool_used(const std::string& pool_name, const PoolStatistics& statistics) override;
 
-    virtual void worker_got_message(unsigned int worker_id, Message* message) override;
-    virtual void worker_says(unsigned int worker_id, const std::string& message) override;
+    virtual void worker_got_message(unsigned int worker_id, const Message& message) override;
+    virtual void worker_says(unsigned int worker_id, std::string_view message) override;
     virtual void worker_starts_election(unsigned int worker_id) override;
     virtual void worker_participates_in_election(unsigned int worker_id) override;
     virtual void worker_proposes_itself_in_election(unsigned int worker_id) override;
@@ -47,8 +65,13 @@ class Logger: public Presenter {
     virtual void worker_stops_election_participation(unsigned int worker_id) override;
     virtual void worker_is_elected(unsigned int worker_id) override;
     virtual void worker_resigns_as_leader(unsigned int worker_id) override;
+    virtual void worker_drops_stale_message(unsigned int worker_id, const Message& message) override;
 
     virtual void election_is_finished(unsigned int leader_id) override;
+    virtual void election_messages_counted(const std::string& election_algorithm, size_t number_of_messages) override;
+    virtual void election_simulated(unsigned int leader_id, size_t number_of_proposals, size_t number_of_elected_messages, double virtual_latency) override;
+    virtual void hierarchy_level_elected(unsigned int level, size_t number_of_rings, double latency) override;
+    virtual void elections_completed(size_t number_of_elections, size_t number_of_completed_elections, size_t number_of_messages, double elapsed_time) override;
 
     virtual void worker_recognizes_dead_neighbour(unsigned int worker_id, unsigned int neighbour_position) override;
     virtual void worker_removes_neighbour(unsigned int worker_id, unsigned int neighbour_position) override;
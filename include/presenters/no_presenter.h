@@ -10,15 +10,20 @@ class NoPresenter: public Presenter {
     void ring_created(size_t) override {}
     void ring_starts() override {}
     void ring_started() override {}
+    void ring_startup_timed(double, double, double, double) override {}
     void ring_stops() override {}
     void ring_stopped() override {}
 
     void worker_created(unsigned int, unsigned int) override {}
     void worker_started(unsigned int) override {}
+    void workers_placed(const std::string&, size_t) override {}
     void worker_stopped(unsigned int) override {}
+    void worker_missed_stop_deadline(unsigned int) override {}
+    void workers_handled_batches(size_t, size_t, size_t) override {}
+    void object_pool_used(const std::string&, const PoolStatistics&) override {}
 
-    void worker_got_message(unsigned int, Message*) override {}
-    void worker_says(unsigned int, const std::string&) override {}
+    void worker_got_message(unsigned int, const Message&) override {}
+    void worker_says(unsigned int, std::string_view) override {}
     void worker_starts_election(unsigned int) override {}
     void worker_participates_in_election(unsigned int) override {}
     void worker_proposes_itself_in_election(unsigned int) override {}
@@ -27,8 +32,13 @@ class NoPresenter: public Presenter {
     void worker_stops_election_participation(unsigned int) override {}
     void worker_is_elected(unsigned int) override {}
     void worker_resigns_as_leader(unsigned int) override {}
+    void worker_drops_stale_message(unsigned int, const Message&) override {}
 
     void election_is_finished(unsigned int) override {}
+    void election_messages_counted(const std::string&, size_t) override {}
+    void election_simulated(unsigned int, size_t, size_t, double) override {}
+    void hierarchy_level_elected(unsigned int, size_t, double) override {}
+    void elections_completed(size_t, size_t, size_t, double) override {}
 
     void worker_recognizes_dead_neighbour(unsigned int, unsigned int) override {}
     void worker_removes_neighbour(unsigned int, unsigned int) override {}
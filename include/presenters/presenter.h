@@ -3,6 +3,7 @@
 #include "messages.h"
 
 #include <spdlog/spdlog.h>
+#include <string_view>
 
 // The Interface for a Presenter, 
 // an object which presents to the users/outputs the called events
@@ -13,15 +14,20 @@ class Presenter {
     virtual void ring_created(size_t ring_size) = 0;
     virtual void ring_starts() = 0;
     virtual void ring_started() = 0;
+    virtual void ring_startup_timed(double id_time, double construction_time, double wiring_time, double start_time) = 0;
     virtual void ring_stops() = 0;
     virtual void ring_stopped() = 0;
 
     virtual void worker_created(unsigned int worker_id, unsigned int position) = 0;
     virtual void worker_started(unsigned int position) = 0;
+    virtual void workers_placed(const std::string& placement, size_t number_of_cpus) = 0;
     virtual void worker_stopped(unsigned int position) = 0;
+    virtual void worker_missed_stop_deadline(unsigned int position) = 0;
+    virtual void workers_handled_batches(size_t number_of_batches, size_t number_of_messages, size_t largest_batch) = 0;
+    virtual void object_pool_used(const std::string& pool_name, const PoolStatistics& statistics) = 0;
 
-    virtual void worker_got_message(unsigned int worker_id, Message* message) = 0;
-    virtual void worker_says(unsigned int worker_id, const std::string& message) = 0;
+    virtual void worker_got_message(unsigned int worker_id, const Message& message) = 0;
+    virtual void worker_says(unsigned int worker_id, std::string_view message) = 0;
     virtual void worker_starts_election(unsigned int worker_id) = 0;
     virtual void worker_participates_in_election(unsigned int worker_id) = 0;
     virtual void worker_proposes_itself_in_election(unsigned int worker_id) = 0;
@@ -30,8 +36,13 @@ class Presenter {
     virtual void worker_stops_election_participation(unsigned int worker_id) = 0;
     virtual void worker_is_elected(unsigned int worker_id) = 0;
     virtual void worker_resigns_as_leader(unsigned int worker_id) = 0;
+    virtual void worker_drops_stale_message(unsigned int worker_id, const Message& message) = 0;
 
     virtual void election_is_finished(unsigned int leader_id) = 0;
+    virtual void election_messages_counted(const std::string& election_algorithm, size_t number_of_messages) = 0;
+    virtual void election_simulated(unsigned int leader_id, size_t number_of_proposals, size_t number_of_elected_messages, double virtual_latency) = 0;
+    virtual void hierarchy_level_elected(unsigned int level, size_t number_of_rings, double latency) = 0;
+    virtual void elections_completed(size_t number_of_elections, size_t number_of_completed_elections, size_t number_of_messages, double elapsed_time) = 0;
 
     virtual void worker_recognizes_dead_neighbour(unsigned int worker_id, unsigned int neighbour_position) = 0;
     virtual void worker_removes_neighbour(unsigned int worker_id, unsigned int neighbour_position) = 0;
@@ -1,41 +1,221 @@
 #pragma once
 
 #include "worker.h"
+#include "placement.h"
+#include "scheduler.h"
+#include "shard.h"
+#include "sized_thread.h"
+#include "transport.h"
+#include "unique_ids.h"
 #include "presenters/presenter.h"
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <thread>
 
+// Options for how the Workers of a Ring are executed.
+// The defaults represent the original behaviour.
+struct ExecutionOptions {
+    // If the Workers run as Tasks on a work-stealing Scheduler
+    // instead of each in its own thread.
+    bool use_tasks{false};
+
+    // If the Workers run in contiguous segments of the Ring,
+    // each in one thread pinned to a core (only without use_tasks).
+    bool use_shards{false};
+
+    // The number of the Scheduler's threads or of Shards; 
+    // 0 is one thread per core.
+    size_t number_of_threads{0};
+
+    // How long stop waits for the Workers in milliseconds,
+    // before it reports those still running; it still waits for them then.
+    unsigned int stop_deadline{5000};
+
+    // How the Workers' own threads are placed on the CPUs;
+    // Shards are always placed compactly and Tasks never.
+    Placement placement{Placement::none};
+};
+
+// Options for how a Ring sets up its Workers.
+struct SetupOptions {
+    // The seed of the Workers' ids, the same seed results in the same ids;
+    // 0 is a random seed.
+    uint64_t seed{0};
+
+    // The stack size in bytes of the threads started while the Workers run
+    // each in its own thread, which are theirs and their Outboxes';
+    // 0 keeps the system's default.
+    size_t stack_size{0};
+
+    // When the Ring is a segment of a Ring spread over processes,
+    // the position of its first Worker in the whole Ring 
+    // and the size of the whole Ring, so all segments share one set of ids;
+    // a size of 0 is the number of the Ring's own Workers.
+    size_t first_position{0};
+    size_t ring_size{0};
+
+    // When it's at least 2 and smaller than the number of Workers,
+    // the Workers are split into sub-rings of at most this size,
+    // whose leaders elect the leader in rings of the same size a level above,
+    // until a single ring is left; 0 is one flat Ring.
+    size_t sub_ring_size{0};
+
+    // How the ids are laid out along the Workers' positions
+    IdLayout id_layout{IdLayout::random};
+
+    // How many Workers, spread evenly over each ring, start an election
+    // with Chang and Roberts or Peterson; 0 is all of them.
+    // Hirschberg and Sinclair is always started by all of them.
+    size_t number_of_initiators{1};
+};
+
+// A level of a hierarchical Ring, whose Workers are split into contiguous rings
+// of about equal size; the Workers of level 0 are the Ring's own
+// and each level above holds one delegate per ring below,
+// which stands in for the leader of that ring.
+struct HierarchyLevel {
+    size_t first_worker; // of the Ring's Workers
+    size_t number_of_workers;
+    size_t number_of_rings;
+
+    // the leaders of the level's rings in the current election,
+    // nullptr while a ring hasn't elected its leader yet
+    std::vector<Worker*> leaders{};
+    std::vector<unsigned int> leader_ids{};
+
+    // The index of the ring the Worker at the index of the level is part of
+    size_t get_ring(size_t index) const;
+    // The index of the first Worker of the ring in the level
+    size_t get_first_of_ring(size_t ring) const;
+};
+
+// The outcome of an election of a Ring.
+struct ElectionResult {
+    unsigned int leader_id{0};
+    // the Messages of the election sent by all Workers, each one hop
+    size_t number_of_messages{0};
+    // from starting the election until the leader learned about it, in ms
+    double elapsed_time{0};
+    // of the election, which no newer one had superseded when it completed
+    uint16_t epoch{0};
+};
+
 // A Ring meant to construct and manage Workers in form of a ring topology.
 class Ring {
   private:
     std::vector<Worker*> workers{};
-    std::vector<std::thread> worker_threads{};
+    Worker* worker_storage{nullptr}; // one block of memory for all Workers
+    std::vector<SizedThread> worker_threads{};
+    std::unique_ptr<Scheduler> scheduler{};
+    std::vector<std::unique_ptr<Shard>> shards{};
+    std::shared_ptr<SharedMembership> membership{};
+    std::unique_ptr<Transport> transport{};
+    // delivers what arrives from the previous segment to the first Worker,
+    // so receiving never waits for the first Worker to take it
+    Outbox transport_outbox{};
+    // assigns the Messages which start and announce the elections,
+    // so neither the caller nor a leader's thread, which may be one of
+    // a Scheduler's few threads, waits for a full mailbox
+    Outbox election_outbox{};
+    ExecutionOptions execution_options;
+    SetupOptions setup_options;
     Presenter* presenter;
+    bool owns_presenter{false};
     bool running{false};
 
+    // how long the parts of the start-up took, in ms
+    double id_time{0};
+    double construction_time{0};
+    double wiring_time{0};
+
+    // Only filled when the Ring is hierarchical, starting with level 0
+    std::vector<HierarchyLevel> levels{};
+    // the progress of the current election through the levels
+    std::mutex hierarchy_mtx;
+    size_t electing_level{0};
+    size_t rings_left{0}; // of the level electing
+    std::chrono::steady_clock::time_point level_start{};
+
+    // the newest election, counted up with each one started,
+    // whose Messages supersede those of the elections before
+    std::atomic<uint16_t> epoch{0};
+    // the outcome of the newest election, while it's going on
+    std::mutex election_mtx;
+    std::promise<ElectionResult> election_promise{};
+    bool is_election_pending{false};
+    std::chrono::steady_clock::time_point election_start{};
+
+    // the Messages of the current election sent by all Workers
+    ElectionMessageCounter election_messages{};
+    ElectionAlgorithm election_algorithm;
+
     void create_workers(
         size_t number_of_workers, 
-        unsigned int worker_sleeptime
+        unsigned int worker_sleeptime,
+        WorkerOptions worker_options
     );
     void set_worker_neighbours();
+    void start_threads(const std::vector<int>& cpus);
+    void start_shards(const std::vector<int>& cpus);
+    void stop_threads();
+    void start_transport();
+    void handle_failed_transport_deliveries();
+    void set_up_levels(size_t number_of_workers);
+    void set_hierarchy_neighbours();
+    void start_level(size_t level);
+    void start_election_among(size_t first_worker, size_t end_worker);
+    void ring_elected(
+        size_t level, 
+        size_t ring, 
+        Worker* leader, 
+        unsigned int leader_id, 
+        uint16_t epoch
+    );
+    void announce_leader(unsigned int leader_id, uint16_t epoch);
+    void complete_election(unsigned int leader_id, uint16_t epoch);
 
   public:
     Ring(
         size_t number_of_workers, 
         unsigned int worker_sleeptime, 
-        Presenter* presenter
+        Presenter* presenter,
+        WorkerOptions worker_options = {},
+        ExecutionOptions execution_options = {},
+        SetupOptions setup_options = {}
     );
 
     ~Ring();
 
-    // Starts all Workers in separate threads.
+    // Connects the Ring as a segment of a Ring spread over processes;
+    // to be called before start and only for a flat Ring.
+    // Its last Worker sends to the next segment through the Transport
+    // and the Messages from the previous segment are assigned to its first Worker.
+    void connect(std::unique_ptr<Transport> transport);
+
+    // Starts all Workers in separate threads, as Tasks of a Scheduler
+    // or in Shards, according to the execution options.
     void start();
 
     // Starts an election among the Workers
-    // according to the Chang and Roberts Algorithm.
-    void start_election();
+    // according to their election algorithm.
+    // Each election has a newer epoch than the ones before, which it supersedes,
+    // so it may be started while they are still going on.
+    // Of a Ring spread over processes, only the first segment starts it.
+    // A hierarchical Ring elects in all sub-rings at once and then level by level,
+    // each level's latency is reported, and finally announces the leader
+    // around all rings below, so every Worker learns about it.
+    // Returns the future outcome, once the leader has learned about it.
+    // It's broken when a newer election supersedes it or the Ring stops before,
+    // and invalid when the Ring doesn't start it; of a Ring spread over processes,
+    // only the leader's segment learns about the outcome.
+    std::future<ElectionResult> start_election();
 
-    // Stops all Workers and joins their threads.
+    // Stops all Workers and joins their, the Scheduler's or the Shards' threads.
     void stop();
 };
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A unit of work which is run by a Scheduler.
+// A Task must not be scheduled again while it's queued or running.
+class Task {
+  public:
+    virtual void run() = 0;
+
+    virtual ~Task() = default;
+};
+
+// A fixed-size pool of threads which run Tasks.
+// Each thread has its own queue and runs its newest Task first;
+// when its queue is empty, it steals the oldest Task of another thread.
+// Threads without any Task to run park on a futex word.
+class Scheduler {
+  private:
+    struct TaskQueue {
+        std::mutex queue_mtx;
+        std::deque<Task*> tasks{};
+    };
+
+    std::vector<std::unique_ptr<TaskQueue>> queues{};
+    std::vector<std::thread> threads{};
+    std::atomic<size_t> next_queue{0}; // for Tasks scheduled outside of the pool
+    std::atomic<bool> running{true};
+
+    // Tasks which are queued, running or delayed
+    std::atomic<size_t> number_of_tasks{0};
+
+    // changed whenever a Task is queued, parked threads wait on it
+    std::atomic<uint32_t> work_signal{0};
+    std::atomic<uint32_t> number_of_parked_threads{0};
+
+    // changed whenever the last Task has finished, for wait_until_idle
+    std::atomic<uint32_t> idle_signal{0};
+    std::atomic<uint32_t> number_of_idle_waiters{0};
+
+    void enqueue(Task* task);
+    Task* find_task(size_t own_queue);
+    void finish_task();
+    void work(size_t own_queue);
+
+  public:
+    // Starts the given number of threads, 0 starts one thread per core.
+    Scheduler(size_t number_of_threads = 0);
+
+    // Waits until the Scheduler is idle and joins its threads.
+    ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    // Queues the Task to be run by one of the threads.
+    void schedule(Task* task);
+
+    // Queues the Task after the delay in milliseconds on the Timing Wheel;
+    // the Task counts as scheduled in the meantime.
+    void schedule_after(Task* task, unsigned int delay);
+
+    // Blocks until no Task is queued, running or delayed anymore.
+    void wait_until_idle();
+
+    size_t get_number_of_threads() const;
+};
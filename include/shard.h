@@ -0,0 +1,124 @@
+#pragma once
+
+#include "messages.h"
+#include "spsc_channel.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Worker; // a forward declaration of Worker as receiver of Deliveries
+
+// A contiguous segment of the Ring, whose Workers all run in one thread,
+// which is pinned to a core.
+// Messages between the Shard's own Workers are queued locally without locks;
+// only Messages to the first Worker of the next Shard cross the cores,
+// through a lock-free Channel between the two Shards.
+// Messages from outside of the Shards and to any other Shard,
+// which are rare, are assigned under a lock.
+// A Message is handled its receiver's sleeptime after it got to the Shard,
+// together with the others due for the receiver up to its batch limit;
+// the rest waits for the receiver's next wakeup a sleeptime later.
+// A Message handled after the receiver's delivery waittime 
+// counts as a failed delivery of its sender.
+class Shard {
+  public:
+    // A Message on its way to a Worker of the next Shard
+    struct Delivery {
+        Worker* receiver;
+        Message message;
+        // nullptr when it's assigned from outside of the Shards
+        Worker* sender{nullptr};
+        std::chrono::steady_clock::time_point deadline{};
+    };
+
+  private:
+    // A Message for one of the Shard's Workers, handled when it's due
+    struct LocalDelivery {
+        std::chrono::steady_clock::time_point due;
+        Worker* receiver;
+        Message message;
+        Worker* sender;
+        // until when the receiver is expected to have handled it
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    // A Delivery which wasn't handled in time, reported to its sender's Shard
+    struct MissedDelivery {
+        Worker* sender;
+        Worker* receiver;
+    };
+
+    size_t index;
+    int cpu{-1}; // to which the thread is pinned
+    std::vector<Worker*> workers{};
+    size_t number_of_running_workers{0};
+    Shard* next_shard{nullptr};
+
+    // only used by the Shard's thread
+    std::chrono::steady_clock::time_point now{};
+    std::deque<LocalDelivery> local_deliveries{}; // in the order they are due
+    std::deque<Delivery> overflow{}; // for the next Shard while its Channel is full
+    // the due Deliveries whose receivers haven't woken up yet
+    std::vector<LocalDelivery> waiting_deliveries{};
+    std::vector<Worker*> batched_workers{};
+    // when the next local Delivery can be handled
+    std::chrono::steady_clock::time_point next_due{};
+
+    // filled by the preceding Shard
+    SpscChannel<Delivery> inbound;
+
+    // filled from outside of the Shards
+    std::mutex assigned_mtx;
+    std::vector<Delivery> assigned_deliveries{};
+    std::atomic<bool> has_assigned_deliveries{false};
+    // the missed Deliveries of the Shard's Workers, also reported by other Shards
+    std::vector<MissedDelivery> missed_deliveries{};
+    std::atomic<bool> has_missed_deliveries{false};
+
+    // Parking of the Shard's thread, a futex word changed on new Messages
+    std::atomic<uint32_t> signal{0};
+    std::atomic<bool> parked{false};
+
+    std::thread thread{};
+
+    void work();
+    void take_incoming_deliveries();
+    void hand_over_overflow();
+    void handle_due_deliveries();
+    void handle_missed_deliveries();
+    void report_missed_delivery(Worker* sender, Worker* receiver);
+    void queue_locally(const Delivery& delivery);
+    void park(uint32_t observed_signal);
+    void wake();
+
+  public:
+    // Messages to the Shard queue up to channel_capacity in its Channel.
+    Shard(size_t index, size_t channel_capacity = 1024);
+
+    ~Shard();
+
+    // Adds a Worker to the end of the Shard's segment.
+    void add_worker(Worker* worker);
+
+    // Sets the Shard which holds the segment after this one.
+    void set_next_shard(Shard* next_shard);
+
+    // Starts the Shard's Workers in its thread,
+    // which is pinned to the CPU unless it's -1.
+    void start(int cpu = -1);
+
+    // Assigns a Message to one of the Shard's Workers from anywhere.
+    void assign(Worker* receiver, const Message& message);
+
+    // Sends a Message from one of the Shard's Workers to the receiver;
+    // only to be called from the Shard's thread.
+    void send(Worker* sender, Worker* receiver, const Message& message);
+
+    // Waits until all of the Shard's Workers have stopped.
+    void join();
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "transport.h"
+#include "presenters/presenter.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A Transport between processes on the same host ("shm:<name>")
+// over single-producer single-consumer ring buffers in shared memory.
+// Each segment creates the ring buffer on which it listens
+// and maps the one of the next segment as soon as it exists.
+// A Message is written as a fixed-size record right into its slot,
+// the receiving process is only woken by a futex when it waits.
+// Like in the wire format of sockets, a NewWorker and the Messages
+// of Hirschberg and Sinclair and of Peterson can't be written
+// and are dropped with an error, so only Chang and Roberts elects across processes;
+// the same goes for a LogMessage whose content is longer than a record holds.
+// The next segment is lost when its process is gone,
+// when it has stopped or when it hasn't taken anything
+// for longer than its first Worker's delivery waittime,
+// then the segment closes into a Ring of its own,
+// until the restarted next segment's ring buffer can be mapped.
+// Only Linux provides the futexes between processes,
+// elsewhere the receiving process polls.
+class ShmTransport: public Transport {
+  private:
+    struct RingBuffer; // the shared memory of a ring buffer
+
+    std::string listen_name;
+    std::string next_name;
+    Presenter* presenter;
+    Receiver receiver{};
+    unsigned int delivery_waittime{1000}; // of this segment's first Worker in ms
+
+    RingBuffer* inbound{nullptr}; // created by this Transport
+    RingBuffer* outbound{nullptr}; // of the next segment, once it's mapped
+
+    std::atomic<bool> running{false};
+    std::atomic<bool> next_lost{false};
+
+    // only used under the lock
+    std::mutex outgoing_mtx;
+    std::condition_variable outgoing_cv;
+    std::deque<Message> pending_messages{}; // while the ring buffer is full
+    // the loss of the next segment, until it's taken with the Messages not sent to it
+    bool is_loss_taken{true};
+    std::vector<Message> unsent_messages{};
+    int32_t lost_consumer_pid{0}; // whose ring buffer isn't mapped again
+    uint64_t observed_tail{0};
+    std::chrono::milliseconds progress_timeout{}; // set when the next segment is mapped
+    std::chrono::steady_clock::time_point last_progress{};
+
+    std::thread reader{};
+    std::thread sender{};
+
+    void read();
+    void check_previous();
+    void send_pending();
+    bool try_push(const Message& message);
+    bool map_next();
+    void unmap_next();
+    void check_next();
+    void lose_next(const std::string& reason);
+
+  public:
+    // Throws invalid_argument if one of the endpoints isn't "shm:<name>".
+    ShmTransport(
+        const std::string& listen_endpoint,
+        const std::string& next_endpoint,
+        Presenter* presenter
+    );
+
+    ~ShmTransport();
+
+    // Throws runtime_error if it can't create its ring buffer.
+    void start(Receiver receiver) override;
+    void send(const Message& message) override;
+    void stop() override;
+    void set_delivery_waittime(unsigned int delivery_waittime) override;
+    bool has_lost_next() const override;
+    bool take_lost_next(std::vector<Message>& unsent_messages) override;
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "election_node.h"
+#include "unique_ids.h"
+#include "presenters/presenter.h"
+#include "presenters/no_presenter.h"
+
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <vector>
+
+// A point in or a span of the virtual time of a Simulation, in microseconds
+using VirtualTime = uint64_t;
+
+// Options for the virtual network of a Simulation.
+struct SimulationOptions {
+    // Seeds the ids of the Workers and the jitter of the links;
+    // the same seed always results in the same Simulation.
+    uint64_t seed{0};
+
+    // The virtual time a Message takes from one Worker to the next, in µs
+    unsigned int link_latency{100};
+
+    // At most this much virtual time is added at random to each hop, in µs;
+    // it never lets a Message overtake another one to the same Worker.
+    unsigned int link_jitter{0};
+
+    // With which algorithm the simulated Workers elect their leader
+    ElectionAlgorithm election_algorithm{ElectionAlgorithm::chang_roberts};
+
+    // How the ids are laid out along the Workers' positions
+    IdLayout id_layout{IdLayout::random};
+
+    // How many Workers, spread evenly over the ring, start an election
+    // with Chang and Roberts or Peterson; 0 is all of them.
+    // Hirschberg and Sinclair is always started by all of them.
+    size_t number_of_initiators{1};
+};
+
+// The outcome of a simulated election.
+struct SimulatedElection {
+    bool is_finished{false};
+    unsigned int leader_id{0};
+    // the proposals or the probes and replies
+    size_t number_of_proposals{0};
+    size_t number_of_elected_messages{0};
+    // from the start of the election until the leader learned about it
+    VirtualTime latency{0};
+};
+
+// A deterministic, single-threaded Simulation of a Ring.
+// The Workers' Messages are events on a virtual clock instead of
+// being delivered between threads, and the Workers' sleeptimes only pass
+// virtually, so an election takes as long as handling its Messages takes.
+// The Workers are simulated by nodes, which only hold what a Worker knows
+// about the elections and handle their Messages with a Worker's election logic,
+// so even rings of millions of Workers fit into memory.
+// Only the Simulation's events are presented, 
+// since presenting every hop would take far longer than simulating it.
+class Simulation: public ElectionNode {
+  private:
+    // The timing of a simulated Worker, whose ElectionState is kept apart
+    struct Node {
+        // until when it handles its previous Message
+        VirtualTime busy_until{0};
+        // when the last Message to it arrives
+        VirtualTime last_arrival{0};
+    };
+
+    // A Message which is handled by its receiver
+    struct Event {
+        VirtualTime time;
+        uint64_t sequence; // orders Events at the same time by their creation
+        uint32_t receiver; // the position of its node
+        Message message;
+    };
+
+    struct IsLater {
+        bool operator()(const Event& event, const Event& other) const {
+            return event.time > other.time
+                   ||
+                   (event.time == other.time && event.sequence > other.sequence);
+        }
+    };
+
+    std::vector<Node> nodes{}; // by position
+    // by position as well, so an ElectionState tells its node's position
+    std::vector<ElectionState> election_states{};
+    std::priority_queue<Event, std::vector<Event>, IsLater> events{};
+    VirtualTime now{0};
+    uint64_t next_sequence{0};
+    VirtualTime worker_sleeptime; // in µs
+    SimulationOptions options;
+    std::mt19937_64 random_generator;
+    // presents the Simulation's events, while the nodes are presented to no one
+    Presenter* simulation_presenter;
+    bool owns_presenter{false};
+    NoPresenter node_presenter{};
+    SimulatedElection election{};
+    VirtualTime election_start{0};
+    uint16_t epoch{0}; // of the current election, like the Ring's
+
+    void create_nodes(size_t number_of_workers);
+    void push_event(VirtualTime time, uint32_t receiver, const Message& message);
+    void handle_event(Event& event);
+    void receive(uint32_t receiver, VirtualTime arrival, const Message& message);
+
+    // Sends the Message to the node at the position over the virtual network.
+    void send(uint32_t receiver, const Message& message);
+    void send_to_neighbour_of(ElectionState& node, const Message& message) override;
+    void send_to_predecessor_of(ElectionState& node, const Message& message) override;
+    void finish_election(ElectionState& node) override;
+    uint32_t get_position(const ElectionState& node) const;
+
+  public:
+    Simulation(
+        size_t number_of_workers,
+        unsigned int worker_sleeptime, // in milliseconds
+        Presenter* presenter,
+        SimulationOptions options = {}
+    );
+
+    ~Simulation();
+
+    // Simulates an election started by the first Worker,
+    // until no Messages are left, and reports its outcome.
+    SimulatedElection simulate_election();
+
+    // The current virtual time
+    VirtualTime get_time() const;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <pthread.h>
+
+// A thread started with a stack size of its own, which std::thread can't be given,
+// without changing the default of the process for any other thread.
+// Like std::thread it needs to be joined before it's destroyed.
+class SizedThread {
+  private:
+    pthread_t handle{};
+    bool is_joinable{false};
+
+  public:
+    SizedThread() = default;
+
+    // Starts the function in a new thread with the stack size in bytes;
+    // 0 or a stack size which can't be used is the system's default.
+    // Throws system_error, if the thread can't be started.
+    SizedThread(size_t stack_size, std::function<void()> function);
+
+    SizedThread(SizedThread&& other) noexcept;
+    SizedThread& operator=(SizedThread&& other) noexcept;
+
+    SizedThread(const SizedThread&) = delete;
+    SizedThread& operator=(const SizedThread&) = delete;
+
+    ~SizedThread();
+
+    // If the stack size can be given to a thread, 0 always can
+    static bool can_use_stack_size(size_t stack_size);
+
+    // if the thread has been started and not yet joined
+    bool joinable() const;
+
+    // Waits for the thread to finish.
+    void join();
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "transport.h"
+#include "presenters/presenter.h"
+
+#include <asio.hpp>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A Transport over stream sockets, either Unix-domain ("unix:<path>")
+// or TCP ("tcp:<address>:<port>", e.g. on the loopback).
+// It listens for the previous segment, accepting it again if it reconnects,
+// and connects to the next segment, retrying until it's there.
+// Messages are encoded in the wire format;
+// those sent while a write is in flight are collected
+// and written together with the next write.
+// The next segment is lost when a write to it fails, when it closes the connection
+// or when more bytes wait for it than are allowed, also while it isn't connected yet;
+// then the segment closes into a Ring of its own, until it's connected again.
+// All socket operations run in one thread of its own.
+class SocketTransport: public Transport {
+  private:
+    using Protocol = asio::generic::stream_protocol;
+
+    asio::io_context io_context{};
+    asio::executor_work_guard<asio::io_context::executor_type> work_guard;
+    asio::basic_socket_acceptor<Protocol> acceptor;
+    Protocol::socket inbound; // from the previous segment
+    Protocol::socket outbound; // to the next segment
+    asio::steady_timer retry_timer;
+    Protocol::endpoint listen_endpoint;
+    Protocol::endpoint next_endpoint;
+    std::string socket_path{""}; // of a Unix-domain socket, removed at the end
+    Presenter* presenter;
+    Receiver receiver{};
+    std::thread io_thread{};
+
+    std::atomic<bool> next_lost{false};
+
+    std::mutex outgoing_mtx;
+    std::vector<uint8_t> pending_bytes{}; // encoded, but not written yet
+    std::vector<uint8_t> written_bytes{}; // being written
+    bool is_connected{false};
+    bool is_writing{false};
+    bool running{false};
+    // the loss of the next segment, until it's taken with the Messages not sent to it
+    bool is_loss_taken{true};
+    std::vector<Message> unsent_messages{};
+
+    // only used by the thread of the sockets
+    std::vector<uint8_t> read_buffer;
+    std::vector<uint8_t> incoming_bytes{}; // received, but not decoded yet
+    uint8_t watch_byte{0}; // the next segment never sends anything
+
+    void accept();
+    void read();
+    void receive_incoming_bytes();
+    void connect();
+    void watch_next();
+    void write();
+    void lose_next(const std::string& reason);
+    void keep_unsent(const std::vector<uint8_t>& bytes, size_t number_of_sent_bytes);
+
+  public:
+    // Throws invalid_argument if one of the endpoints isn't valid.
+    SocketTransport(
+        const std::string& listen_endpoint,
+        const std::string& next_endpoint,
+        Presenter* presenter
+    );
+
+    ~SocketTransport();
+
+    // Throws if it can't listen on its endpoint.
+    void start(Receiver receiver) override;
+    void send(const Message& message) override;
+    void stop() override;
+    bool has_lost_next() const override;
+    bool take_lost_next(std::vector<Message>& unsent_messages) override;
+
+    // Parses an endpoint as "unix:<path>" or "tcp:<address>:<port>".
+    // Throws invalid_argument if it's neither.
+    static Protocol::endpoint parse_endpoint(const std::string& endpoint);
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "message_queue.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+// A bounded, lock-free Channel for a single producer and a single consumer.
+// Each side only writes its own position and keeps a cached copy
+// of the other side's, so the positions only move between the cores
+// when the cached copy runs out.
+// Neither side blocks; it's up to them to wait or retry.
+template<typename T>
+class SpscChannel {
+    static_assert(
+        std::is_trivially_copyable<T>::value,
+        "the elements of a Channel are copied bytewise between threads"
+    );
+
+  private:
+    const size_t capacity; // always a power of 2
+    std::unique_ptr<T[]> slots;
+
+    // written by the producer
+    alignas(cache_line_size) std::atomic<size_t> push_position{0};
+    size_t cached_pop_position{0};
+
+    // written by the consumer
+    alignas(cache_line_size) std::atomic<size_t> pop_position{0};
+    size_t cached_push_position{0};
+
+  public:
+    // The capacity is rounded up to the next power of 2.
+    explicit SpscChannel(size_t capacity):
+        capacity{round_up_to_power_of_2(capacity)},
+        slots{std::make_unique<T[]>(this->capacity)}
+    {}
+
+    // Pushes the value, if the Channel isn't full.
+    // Returns if it was pushed; only to be called by the producer.
+    bool try_push(const T& value) {
+        size_t position{push_position.load(std::memory_order_relaxed)};
+
+        if (position - cached_pop_position == capacity) {
+            cached_pop_position = pop_position.load(std::memory_order_acquire);
+
+            if (position - cached_pop_position == capacity) {
+                return false;
+            }
+        }
+
+        slots[position & (capacity - 1)] = value;
+        push_position.store(position + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Pops the oldest value, if the Channel isn't empty.
+    // Returns if one was popped; only to be called by the consumer.
+    bool try_pop(T& value) {
+        size_t position{pop_position.load(std::memory_order_relaxed)};
+
+        if (position == cached_push_position) {
+            cached_push_position = push_position.load(std::memory_order_acquire);
+
+            if (position == cached_push_position) {
+                return false;
+            }
+        }
+
+        value = slots[position & (capacity - 1)];
+        pop_position.store(position + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Returns if the Channel is empty, as seen from the calling thread.
+    bool is_empty() const {
+        return push_position.load(std::memory_order_acquire)
+                ==
+               pop_position.load(std::memory_order_acquire);
+    }
+
+    size_t get_capacity() const {
+        return capacity;
+    }
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// A process-wide hierarchical Timing Wheel with a resolution of 1 ms.
+// Timers are inserted and cancelled in O(1) and their callbacks
+// are called on the wheel's own thread when they expire.
+// Each of its levels has 64 slots, a slot on level l spans 64^l ms.
+class TimingWheel {
+ #ifdef UNIT_TEST 
+  public: // Needed for the unit tests to be able to examine inner workings
+ #else
+  private:
+ #endif
+    struct Timer {
+        uint64_t expiry_tick{0};
+        uint64_t generation{0}; // increased whenever the Timer is reused
+        std::function<void()> callback;
+        Timer* previous{nullptr};
+        Timer* next{nullptr};
+    };
+
+    // A doubly-linked list of Timers with the list head as sentinel
+    struct Slot {
+        Timer head;
+
+        Slot() { head.previous = head.next = &head; }
+        bool is_empty() const { return head.next == &head; }
+    };
+
+    static constexpr unsigned int slot_bits{6};
+    static constexpr uint64_t slots_per_level{1 << slot_bits};
+    static constexpr unsigned int number_of_levels{5};
+
+    std::array<std::array<Slot, slots_per_level>, number_of_levels> levels{};
+    Slot free_timers{};
+    size_t number_of_timers{0};
+
+    uint64_t current_tick{0};
+    const std::chrono::steady_clock::time_point start_time;
+
+    const Timer* firing_timer{nullptr};
+    bool running{true};
+    std::mutex wheel_mtx;
+    std::condition_variable timers_changed;
+    std::condition_variable timer_fired;
+    std::thread ticker;
+
+    TimingWheel();
+
+    uint64_t get_tick(std::chrono::steady_clock::time_point time) const;
+    void link(Timer* timer);
+    void append(Slot& slot, Timer* timer);
+    void unlink(Timer* timer);
+    void recycle(Timer* timer);
+    void advance(Slot& expired_timers);
+    void tick();
+
+  public:
+    // Identifies a scheduled Timer, meant for cancelling it
+    struct Handle {
+        Timer* timer{nullptr};
+        uint64_t generation{0};
+    };
+
+    ~TimingWheel();
+
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+
+    // The one Timing Wheel of the process, started on its first use
+    static TimingWheel& get_instance();
+
+    // Schedules the callback to be called at the deadline.
+    // The callback is called on the wheel's thread 
+    // and must not cancel its own Timer.
+    Handle schedule(
+        std::chrono::steady_clock::time_point deadline,
+        std::function<void()> callback
+    );
+
+    // Cancels the Timer, when it hasn't expired yet.
+    // If its callback is running, it blocks until the callback has finished.
+    // Returns if the Timer has been cancelled before it expired.
+    bool cancel(Handle handle);
+};
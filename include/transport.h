@@ -0,0 +1,60 @@
+#pragma once
+
+#include "messages.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// The link from a segment of a Ring to the next segment,
+// when the Ring is spread over several processes.
+// The last Worker of a segment sends through it
+// and what arrives from the previous segment is handed to the Receiver,
+// which assigns it to the segment's first Worker.
+class Transport {
+  public:
+    using Receiver = std::function<void(const Message&)>;
+
+    // Starts sending to the next and receiving from the previous segment.
+    virtual void start(Receiver receiver) = 0;
+
+    // Sends the Message to the next segment without blocking
+    // and takes care of disposing it; it may be called from any thread.
+    // Messages sent while it's not running are dropped.
+    virtual void send(const Message& message) = 0;
+
+    // Stops sending and receiving; Messages which weren't sent yet are dropped.
+    virtual void stop() = 0;
+
+    // Tells the Transport how long in ms the segment's first Worker is granted
+    // to take a Message, so the previous segment grants this segment as much;
+    // it's called before start.
+    virtual void set_delivery_waittime(unsigned int /* delivery_waittime */) {}
+
+    // If the next segment is known to be gone, until a restarted one is reached,
+    // so the segment closes into a Ring of its own meanwhile.
+    virtual bool has_lost_next() const {
+        return false;
+    }
+
+    // Returns if the next segment has been lost since the last call
+    // and appends the Messages which weren't sent to it yet, in their order,
+    // so the Worker before the first position removes it like a dead neighbour.
+    virtual bool take_lost_next(std::vector<Message>& /* unsent_messages */) {
+        return false;
+    }
+
+    virtual ~Transport() = default;
+};
+
+class Presenter;
+
+// Creates the Transport for the kind of the endpoints,
+// which are "shm:<name>" for a ShmTransport and sockets otherwise.
+// Throws invalid_argument if an endpoint isn't valid.
+std::unique_ptr<Transport> make_transport(
+    const std::string& listen_endpoint, 
+    const std::string& next_endpoint, 
+    Presenter* presenter
+);
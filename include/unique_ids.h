@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// How the ids are laid out along the positions of a Ring
+enum class IdLayout {
+    random,     // in the order of the bijection keyed by the seed
+    ascending,  // increasing along the ring, the highest id at the last position
+    descending, // decreasing along the ring, the highest id at the first position
+    // the worst case of Chang and Roberts for the initiators:
+    // the highest id at the last position, the initiators with the next highest
+    // decreasing along the ring and the others with the lowest
+    adversarial
+};
+
+// The name of the IdLayout, as it's configured
+std::string to_string(IdLayout id_layout);
+
+// Parses the name of an IdLayout, returns false if there is none of it
+bool id_layout_from_string(const std::string& name, IdLayout& id_layout);
+
+// The positions of the Workers which start an election, spread evenly 
+// over the ring from its first position; 0 initiators are all of them.
+std::vector<size_t> get_initiator_positions(size_t ring_size, size_t number_of_initiators);
+
+// Returns the requested amount of unique ids in a random order,
+// out of 0 to 999 for less than 100 ids and otherwise out of 0 to 10 times the amount.
+// The ids are the positions permuted by a bijection keyed by the seed,
+// so they are computed in O(n), in parallel and without any bookkeeping;
+// the same seed always results in the same ids.
+std::vector<unsigned int> get_unique_ids(size_t number_of_ids, uint64_t seed);
+
+// Returns the same ids as above in the IdLayout,
+// the adversarial one for the number of initiators.
+std::vector<unsigned int> get_unique_ids(
+    size_t number_of_ids, 
+    uint64_t seed, 
+    IdLayout id_layout, 
+    size_t number_of_initiators = 1
+);
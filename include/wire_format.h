@@ -0,0 +1,31 @@
+#pragma once
+
+#include "messages.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The compact binary encoding of Messages between processes.
+// Each Message is its type as one byte, followed by
+//   the id as 4 bytes and the epoch as 2 bytes in little-endian (ElectionProposal, Elected),
+//   the position as 4 bytes in little-endian (DeadWorker),
+//   the epoch as 2 bytes in little-endian (StartElection),
+//   the length of its content as 4 bytes in little-endian and the content (LogMessage)
+//   or nothing (NoMessage, Stop).
+// A NewWorker refers to a Worker of the process and can't be encoded,
+// neither can a LogMessage whose content is longer than 64 KiB
+// nor the Probes and Replies of Hirschberg and Sinclair
+// or the Candidates and PreviousCandidates of Peterson,
+// so only Chang and Roberts elects across processes.
+
+// Appends the encoded Message to the bytes.
+// Returns false and appends nothing if it can't be encoded.
+bool encode_message(const Message& message, std::vector<uint8_t>& bytes);
+
+// Decodes the first Message of the bytes and returns the number of bytes it took,
+// or 0 if the bytes end before the Message.
+// A decoded LogMessage owns its content, like one which is created.
+// Throws invalid_argument if the bytes don't start with a known type
+// or with a LogMessage whose content is longer than 64 KiB.
+size_t decode_message(const uint8_t* bytes, size_t number_of_bytes, Message& message);
@@ -1,67 +1,200 @@
 #pragma once
 
+#include "election_algorithm.h"
+#include "election_node.h"
+#include "membership.h"
 #include "message_buffer.h"
+#include "outbox.h"
 #include "presenters/presenter.h"
+#include "scheduler.h"
+#include "transport.h"
+#include "worker_coroutine.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <vector>
-#include <future>
+
+class Shard; // a forward declaration of the Shard a Worker may run in
 
 // The return type for act_upon_message.
 // Represents the decision if the loop in operator() should continue, 
 //                      or if it should finish.
 using ContinueOperation = bool;
 
+// Options for tuning the communication of a Worker.
+// The defaults represent the original behaviour,
+// whereas the configuration defaults to a mailbox of 64 and batches of 64.
+struct WorkerOptions {
+    // How many Messages the mailbox can hold;
+    // 1 is the single-slot rendezvous Message Buffer.
+    size_t mailbox_capacity{1};
+
+    // How many Messages are handled at most per wakeup;
+    // 1 handles one Message per wakeup like originally, 0 is taken as 1.
+    size_t batch_limit{1};
+
+    // How often the empty mailbox is polled before the Worker parks;
+    // 0 parks right away like originally.
+    unsigned int spin_limit{0};
+
+    // With which algorithm the Workers elect their leader;
+    // all Workers of a Ring need to use the same.
+    ElectionAlgorithm election_algorithm{ElectionAlgorithm::chang_roberts};
+};
+
+// Statistics about the batches of Messages a Worker handled per wakeup.
+struct BatchStatistics {
+    size_t number_of_batches{0};
+    size_t number_of_messages{0};
+    size_t largest_batch{0};
+
+    void add_batch(size_t batch_size);
+    BatchStatistics& operator+=(const BatchStatistics& other);
+};
+
+// Counts the Messages of an election sent by all Workers of a Ring.
+// A Message of a newer epoch starts the count of its election,
+// those of older epochs aren't counted anymore.
+class ElectionMessageCounter {
+  private:
+    // the epoch in the upper 16 bits and its count in the lower 48 bits
+    std::atomic<uint64_t> epoch_and_count{0};
+
+  public:
+    void count(uint16_t epoch);
+    // Returns the count of the epoch's Messages and resets it,
+    // or 0 if a newer epoch is counted already.
+    size_t take(uint16_t epoch);
+};
+
 // A Worker as a node in the Ring.
-class Worker {
+// It runs either in its own thread with operator(),
+// as a Task of a Scheduler, which runs it whenever its mailbox isn't empty,
+// or in a Shard together with its neighbouring Workers.
+// It runs the election logic of an ElectionNode on its own ElectionState.
+class Worker: public Task, public ElectionNode {
+    // A Shard delivers the Messages of its Workers itself
+    friend class Shard;
+
  #ifdef UNIT_TEST 
   public: // Needed for the unit tests to be able to examine inner workings
  #else
   private:
  #endif
-    unsigned int id;
+    ElectionState election;
     unsigned int position;
     unsigned int sleeptime; // in ms
+    size_t batch_limit;
     
     MessageBuffer message_buffer;
-    bool is_leader{false};
-    bool participates_in_election{false};
-    bool running{false};
-    Presenter* presenter;
-    std::future<bool> previous_message_sent;
+    std::vector<Message> batch{};
+    BatchStatistics batch_statistics{};
+    std::atomic<bool> running{false};
+    // The control lane of a Worker in its own thread, 
+    // set once to stop it and waited on while it sleeps.
+    std::atomic<uint32_t> stop_signal{0};
+    int cpu{-1}; // to which the Worker's own thread is pinned
+    size_t sender_stack_size{0}; // of its Outbox's sender thread, 0 is the default
+    bool owns_presenter{false};
+    Outbox outbox;
+
+    // Only set when the Worker is run as a Task
+    Scheduler* scheduler{nullptr};
+    // if the Task is queued or running, so it's only scheduled once
+    std::atomic<bool> scheduled{false};
+
+    // Only set when the Worker runs in a Shard,
+    // which then delivers the Messages assigned to and sent by it
+    Shard* shard{nullptr};
+    // when it takes its next batch after it left Messages behind, only used by its Shard
+    std::chrono::steady_clock::time_point shard_wakeup{};
+
+    // Only set when the Ring is a segment of a Ring spread over processes;
+    // the Worker before the first position sends through it to the next segment.
+    Transport* transport{nullptr};
+
+    // Only set when the Worker is part of a hierarchical Ring,
+    // which takes over once the Worker's ring has elected it.
+    std::function<void(unsigned int leader_id, uint16_t epoch)> election_handler{};
+
+    // Only set when the Worker is part of a Ring,
+    // which completes the election instead, once the Worker has been elected.
+    std::function<void(unsigned int leader_id, uint16_t epoch)> completion_handler{};
+
+    // Only set when the Worker is part of a Ring,
+    // which counts the Messages of each election among all of its Workers
+    ElectionMessageCounter* election_message_counter{nullptr};
 
-    // Pointers to all Workers in the Ring, ordered by sending distance
-    // The closest Neighbour to which to send Messages is at index 0.
-    // Itself is at the last position in the vector.
-    std::vector<Worker*> neighbours{};
+    // The Membership of the Ring shared by all of its Workers
+    // and the version of it the Worker reads;
+    // the neighbour to which to send Messages is the Worker after its position.
+    std::shared_ptr<SharedMembership> shared_membership{};
+    std::shared_ptr<const Membership> membership{};
 
     void set_presenter(Presenter* presenter);
+    void sleep();
+    bool is_stop_requested();
+    void discard_mailbox();
 
-    ContinueOperation act_upon_message(Message* message);
-    void start_election();
-    void participate_in_election(ElectionProposal* proposal);
-    void forward_election_proposal(ElectionProposal* proposal);
-    void be_elected();
-    void propose_oneself();
-    void end_election(Elected* elected);
-
-    void handle_dead_worker(DeadWorker* dead_worker);
-    void add_new_worker(NewWorker* new_worker);
-    unsigned int get_neighbours_index_for_position(unsigned int position);
-    void remove_dead_worker(unsigned int position);
+    ContinueOperation act_upon_messages(std::vector<Message>& messages);
+    ContinueOperation act_upon_message(Message& message);
+    void finish_election(ElectionState& node) override;
+    bool has_level_above() const override;
+    void report_election_messages();
+
+    void handle_dead_worker(const Message& dead_worker);
+    void add_new_worker(const Message& new_worker);
+    void remove_dead_neighbour(Worker* neighbour, unsigned int position);
+    void refresh_membership();
+    Worker* get_direct_neighbour();
     unsigned int get_direct_neighbour_position();
+    Worker* get_predecessor();
+
+    void send_to_neighbour(const Message& message);
+    void send_to_predecessor(const Message& message);
+    void send_to_neighbour_of(ElectionState& node, const Message& message) override;
+    void send_to_predecessor_of(ElectionState& node, const Message& message) override;
+    void send_to(Worker* receiver, const Message& message);
+    void handle_failed_deliveries();
+    void handle_failed_deliveries(const std::vector<Worker*>& failed_receivers);
+    void handle_lost_segment();
+
+    void schedule(unsigned int delay);
+
+ #ifdef WITH_COROUTINES
+    // Suspends the coroutine while the mailbox is empty,
+    // until the Worker is scheduled again.
+    struct MailboxAwaiter {
+        Worker& worker;
+        bool has_queued_deliveries;
+
+        bool await_ready();
+        bool await_suspend(std::coroutine_handle<>);
+        void await_resume() {}
+    };
 
-    void send_to_neighbour(Message* message);
+    WorkerCoroutine coroutine{};
+
+    WorkerCoroutine live();
+ #endif
 
   public:
     Worker(
         unsigned int id, 
         unsigned int position,
         unsigned int sleeptime, // in milliseconds
-        Presenter* presenter
-    ): id{id}, 
+        Presenter* presenter,
+        WorkerOptions options = {}
+    ): ElectionNode{options.election_algorithm},
+       election{id},
        position{position},
-       sleeptime{sleeptime}   
+       sleeptime{sleeptime},
+       batch_limit{std::max(options.batch_limit, size_t{1})},
+       message_buffer{options.mailbox_capacity, options.spin_limit}
     {
         set_presenter(presenter);
     }
@@ -71,23 +204,91 @@ class Worker {
     // Assigns a Message to the Worker's Message Buffer for execution 
     // and blocks until it's taken.
     // If it times out, it returns false otherwise true
-    bool assign_message_and_wait(Message* message);
+    // Only meant for Workers which run in their own thread.
+    bool assign_message_and_wait(const Message& message);
 
     // Assigns a Message to the Worker's Message Buffer for execution 
     // but doesn't for it to be taken, only for it to be received by the Buffer.
-    void assign_message(Message* message);
+    void assign_message(const Message& message);
+
+    // Assigns a Message to the Worker's Message Buffer for execution,
+    // when there is space for it before the deadline.
+    // Returns if it was assigned and sets the ticket for has_taken.
+    bool assign_message_until(
+        const Message& message, 
+        std::chrono::steady_clock::time_point deadline, 
+        DeliveryTicket& ticket
+    );
+
+    // If the Message identified by the ticket has been taken for execution
+    bool has_taken(DeliveryTicket ticket);
+
+    // The time in milliseconds the Worker is granted to take an assigned Message,
+    // before it's considered dead.
+    unsigned int get_delivery_waittime() const;
 
     // The execution loop which handles all incoming Messages 
     // and implements the functionalities for the concrete ring node.
     void operator()();
 
-    // Sets the neighbours of the Worker.
-    // Throws invalid_argument when the vector is empty.
-    void set_neighbours(std::vector<Worker*> neighbours);
+    // Sets the Transport to the next segment of a Ring spread over processes,
+    // through which the Worker sends when its neighbour is the first position.
+    void set_transport(Transport* transport);
+
+    // Sets what's called instead of finishing the election,
+    // once the Worker's ring of a hierarchical Ring has elected it.
+    // Then an Elected Message for another Worker announces the leader 
+    // of the level above, for which the leader resigns and which is passed
+    // around the ring once; a delegate is sent a StandIn in each epoch,
+    // whose id it takes on.
+    void set_election_handler(
+        std::function<void(unsigned int leader_id, uint16_t epoch)> election_handler
+    );
+
+    // Sets what's called instead of reporting the election,
+    // once the Worker has been elected and has learned about it.
+    void set_completion_handler(
+        std::function<void(unsigned int leader_id, uint16_t epoch)> completion_handler
+    );
+
+    // Sets the counter of the Messages of each election shared by all Workers of the Ring;
+    // the leader reports and resets it, once it has been elected.
+    void set_election_message_counter(ElectionMessageCounter* election_message_counter);
+
+    // Sets the CPU to which the Worker pins its own thread, -1 for none;
+    // its Outbox's sender thread inherits it.
+    void set_cpu(int cpu);
+
+    // Sets the stack size in bytes of its Outbox's sender thread,
+    // 0 for the system's default.
+    void set_sender_stack_size(size_t stack_size);
+
+    // Requests the Worker in its own thread to stop without blocking.
+    // Its sleep is cut short and it stops after its current batch
+    // instead of behind the Messages in its mailbox.
+    void request_stop();
+
+    // Starts the Worker as a Task of the Scheduler instead of in its own thread;
+    // it's scheduled whenever a Message is assigned to it.
+    void start_as_task(Scheduler* scheduler);
+
+    // Handles the Messages in the mailbox like one iteration of operator(),
+    // without blocking, and schedules itself again if there are more.
+    // Built with coroutines, it resumes the Worker's coroutine instead.
+    void run() override;
+
+    // Sets the Membership of the Ring the Worker is part of,
+    // in which it's expected at its position.
+    // Throws invalid_argument when there is none.
+    void set_membership(std::shared_ptr<SharedMembership> shared_membership);
 
     // if the worker is in the method operator()
     bool is_running() const;
 
+    // The sizes of the batches handled so far,
+    // only meant to be read when the worker isn't running.
+    const BatchStatistics& get_batch_statistics() const;
+
     // if two workers are equal is determined by their id
     bool operator==(const Worker&);
     bool operator!=(const Worker&);
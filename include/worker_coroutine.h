@@ -0,0 +1,67 @@
+#pragma once
+
+// Only built with the meson option coroutines, which requires C++20
+#ifdef WITH_COROUTINES
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+// The coroutine of a Worker which runs as a Task.
+// It starts suspended, is resumed by the Worker's Task
+// and keeps its frame after it has finished, until it's destroyed.
+class WorkerCoroutine {
+  public:
+    struct promise_type {
+        WorkerCoroutine get_return_object() {
+            return WorkerCoroutine{
+                std::coroutine_handle<promise_type>::from_promise(*this)
+            };
+        }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+  private:
+    std::coroutine_handle<promise_type> handle{};
+
+  public:
+    WorkerCoroutine() = default;
+
+    explicit WorkerCoroutine(
+        std::coroutine_handle<promise_type> handle
+    ): handle{handle}
+    {}
+
+    WorkerCoroutine(WorkerCoroutine&& other) noexcept:
+        handle{std::exchange(other.handle, {})}
+    {}
+
+    WorkerCoroutine& operator=(WorkerCoroutine&& other) noexcept {
+        if (this != &other) {
+            if (handle) {
+                handle.destroy();
+            }
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+
+    ~WorkerCoroutine() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    // Resumes the coroutine until its next suspension, unless it has finished.
+    void resume() {
+        if (handle && !handle.done()) {
+            handle.resume();
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,131 @@
+// A Microbenchmark for the per-hop latency of the Message Buffer.
+// It compiles into the executable "message_buffer_benchmark".
+//
+// Usage: message_buffer_benchmark [number of hops]
+#include "message_buffer.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+double measure_assign_and_wait_hop(size_t capacity, unsigned int number_of_hops);
+double measure_ring_hop(
+    size_t capacity, 
+    unsigned int ring_size, 
+    unsigned int number_of_hops, 
+    unsigned int spin_limit = 0
+);
+void print_result(const string& scenario, size_t capacity, double nanoseconds_per_hop);
+
+
+int main(int argc, char* argv[]) {
+    unsigned int number_of_hops{
+        argc > 1 
+        ? (unsigned int)strtoul(argv[1], nullptr, 10) 
+        : 200000u
+    };
+
+    cout << "Per-hop latency of the Message Buffer over " 
+         << number_of_hops << " hops\n\n";
+
+    for (size_t capacity : {1, 64}) {
+        print_result(
+            "assign_and_wait -> take", capacity, 
+            measure_assign_and_wait_hop(capacity, number_of_hops)
+        );
+        print_result(
+            "ring of 2 workers", capacity, 
+            measure_ring_hop(capacity, 2, number_of_hops)
+        );
+        print_result(
+            "ring of 8 workers", capacity, 
+            measure_ring_hop(capacity, 8, number_of_hops)
+        );
+        print_result(
+            "ring of 2 workers spinning 10000 times", capacity, 
+            measure_ring_hop(capacity, 2, number_of_hops, 10000)
+        );
+    }
+}
+
+
+// One sender hands each Message over with assign_and_wait 
+// to one receiver, like a Worker to its neighbour.
+double measure_assign_and_wait_hop(size_t capacity, unsigned int number_of_hops) {
+    MessageBuffer buffer(capacity);
+
+    thread receiver{[&](){
+        for (unsigned int i{0}; i < number_of_hops; i++) {
+            buffer.take();
+        }
+    }};
+
+    auto start{chrono::steady_clock::now()};
+    for (unsigned int i{0}; i < number_of_hops; i++) {
+        buffer.assign_and_wait(Message::no_message(), 1000);
+    }
+    auto end{chrono::steady_clock::now()};
+
+    receiver.join();
+
+    return chrono::duration<double, nano>(end - start).count() / number_of_hops;
+}
+
+// A single token is passed around a ring of threads,
+// each taking from its own Buffer and assigning to the next one's.
+double measure_ring_hop(
+    size_t capacity, 
+    unsigned int ring_size, 
+    unsigned int number_of_hops, 
+    unsigned int spin_limit
+) {
+    vector<unique_ptr<MessageBuffer>> buffers{};
+    for (unsigned int i{0}; i < ring_size; i++) {
+        buffers.push_back(make_unique<MessageBuffer>(capacity, spin_limit));
+    }
+
+    vector<thread> nodes{};
+    for (unsigned int i{0}; i < ring_size; i++) {
+        nodes.emplace_back([&, i](){
+            MessageBuffer& own_buffer{*buffers[i]};
+            MessageBuffer& next_buffer{*buffers[(i + 1) % ring_size]};
+
+            while (true) {
+                Message message{own_buffer.take()};
+                if (message.type == MessageType::Stop) {
+                    break;
+                }
+
+                if (message.id + 1 >= number_of_hops) {
+                    // the last hop, stop every node
+                    for (unsigned int j{0}; j < ring_size; j++) {
+                        buffers[j]->assign(Message::stop());
+                    }
+                }
+                else {
+                    next_buffer.assign(Message::election_proposal(message.id + 1));
+                }
+            }
+        });
+    }
+
+    auto start{chrono::steady_clock::now()};
+    buffers[0]->assign(Message::election_proposal(0));
+    for (auto& node : nodes) {
+        node.join();
+    }
+    auto end{chrono::steady_clock::now()};
+
+    return chrono::duration<double, nano>(end - start).count() / number_of_hops;
+}
+
+void print_result(const string& scenario, size_t capacity, double nanoseconds_per_hop) {
+    cout << "  " << scenario 
+         << " (capacity " << capacity << "): "
+         << (unsigned long)nanoseconds_per_hop << " ns/hop\n";
+}
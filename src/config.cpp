@@ -5,6 +5,7 @@
 #include "toml.hpp"
 #include <spdlog/sinks/stdout_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
+#include <map>
 #include <memory>
 #include <fstream>
 #include <sstream>
@@ -16,6 +17,7 @@ shared_ptr<spdlog::logger> get_and_start_logger(const Config&);
 shared_ptr<spdlog::logger> get_and_start_file_logger(const Config&);
 shared_ptr<spdlog::logger> get_console_logger();
 void write_log_start(shared_ptr<spdlog::logger>&);
+string get_endpoint_scheme(const string&);
 
 
 ConfigExit configure(int argc, char* argv[], Config& config) {
@@ -46,12 +48,202 @@ ConfigExit configure(int argc, char* argv[], Config& config) {
         "Sleeptime after each Election in milliseconds\n"
             "  Default is a sleeptime of 5 seconds"
     );
+    app.add_flag(
+        "--closed-loop",
+        config.closed_loop,
+        "Starts each election as soon as the one before has completed\n"
+            "  --sleep is then the time an election may take at most\n"
+            "  The throughput of the given number of elections is logged at INFO\n"
+            "  Not with --segment-of"
+    );
     app.add_option(
         "--worker-sleep",
         config.worker_sleeptime,
         "Sleeptime of each worker after finishing an operation in milliseconds\n"
             "  Default is a sleeptime of 500 milliseconds"
     );
+    app.add_option(
+        "--mailbox-capacity",
+        config.mailbox_capacity,
+        "Number of Messages each worker's mailbox can hold\n"
+            "  1 uses the single-slot rendezvous buffer,\n"
+            "    together with --batch-limit 1 the original behaviour\n"
+            "  Default is a capacity of 64"
+    )->check(CLI::PositiveNumber);
+    app.add_option(
+        "--batch-limit",
+        config.batch_limit,
+        "Maximal number of Messages a worker handles per wakeup\n"
+            "  1 handles one Message per wakeup like originally\n"
+            "  Default is a limit of 64"
+    )->check(CLI::PositiveNumber);
+    app.add_option(
+        "--worker-spin",
+        config.worker_spin_limit,
+        "Number of times each worker polls its empty mailbox before it parks\n"
+            "  Meant for the lowest hop latency together with --worker-sleep 0\n"
+            "  Default 0 parks right away"
+    );
+    auto tasks_flag{app.add_flag(
+        "--tasks",
+        config.use_tasks,
+        "Runs the workers as tasks on a work-stealing thread pool\n"
+            "  instead of each worker in its own thread\n"
+            "  Not with --shards"
+    )};
+    app.add_flag(
+        "--shards",
+        config.use_shards,
+        "Runs the workers in contiguous segments of the ring,\n"
+            "  each segment in one thread pinned to a core\n"
+            "  Only messages between segments cross the cores\n"
+            "  Not with --tasks"
+    )->excludes(tasks_flag);
+    app.add_option(
+        "--task-threads",
+        config.task_threads,
+        "Number of threads of the pool which runs the workers as tasks\n"
+            "  or number of segments with --shards\n"
+            "  Default 0 is one thread per core"
+    );
+    app.add_option(
+        "--stack-size",
+        config.stack_size,
+        "Stack size of each worker's threads in KiB, when they run in their own threads\n"
+            "  Smaller stacks allow larger rings\n"
+            "  Default 0 is the system's default"
+    );
+    app.add_option(
+        "--stop-deadline",
+        config.stop_deadline,
+        "Time the ring waits for its workers to stop in milliseconds\n"
+            "  All workers are stopped at once, those still running afterwards are reported\n"
+            "  Default is a deadline of 5 seconds"
+    );
+    app.add_option(
+        "--placement",
+        config.placement,
+        "Placement of the workers' own threads on the CPUs\n"
+            "  none ...... left to the operating system\n"
+            "  compact ... neighbouring workers on the same CPU or on CPUs sharing caches\n"
+            "  scatter ... neighbouring workers on different CPUs\n"
+            "  Segments of --shards are always placed compactly\n"
+            "  Default is none"
+    )->transform(CLI::CheckedTransformer(
+        map<string, Placement>{
+            {"none", Placement::none},
+            {"compact", Placement::compact},
+            {"scatter", Placement::scatter}
+        },
+        CLI::ignore_case
+    ));
+    app.add_option(
+        "--election",
+        config.election_algorithm,
+        "Algorithm with which the workers elect their leader\n"
+            "  chang-roberts ......... proposals only travel along the ring,\n"
+            "                          O(n^2) messages in the worst case\n"
+            "  hirschberg-sinclair ... candidates probe both of their sides in doubling distances,\n"
+            "                          O(n log n) messages\n"
+            "  peterson .............. active workers compare the two active ones before them,\n"
+            "                          only along the ring, O(n log n) messages\n"
+            "  The messages of each election are counted and logged at INFO\n"
+            "  Default is chang-roberts"
+    )->transform(CLI::CheckedTransformer(
+        map<string, ElectionAlgorithm>{
+            {"chang-roberts", ElectionAlgorithm::chang_roberts},
+            {"hirschberg-sinclair", ElectionAlgorithm::hirschberg_sinclair},
+            {"peterson", ElectionAlgorithm::peterson}
+        },
+        CLI::ignore_case
+    ));
+    app.add_option(
+        "--id-layout",
+        config.id_layout,
+        "Layout of the worker ids along the ring\n"
+            "  random ........ in a random order\n"
+            "  ascending ..... increasing along the ring\n"
+            "  descending .... decreasing along the ring\n"
+            "  adversarial ... the worst case of chang-roberts for the initiators\n"
+            "  The ids themselves only depend on --seed\n"
+            "  Default is random"
+    )->transform(CLI::CheckedTransformer(
+        map<string, IdLayout>{
+            {"random", IdLayout::random},
+            {"ascending", IdLayout::ascending},
+            {"descending", IdLayout::descending},
+            {"adversarial", IdLayout::adversarial}
+        },
+        CLI::ignore_case
+    ));
+    app.add_option(
+        "--initiators",
+        config.number_of_initiators,
+        "Number of workers, spread evenly over the ring, which start each election\n"
+            "  hirschberg-sinclair is always started by all workers\n"
+            "  Default is 1, 0 is all workers"
+    );
+    app.add_option(
+        "--sub-ring-size",
+        config.sub_ring_size,
+        "Size of the sub-rings of a hierarchical ring\n"
+            "  Each sub-ring elects a leader, the leaders elect a leader in rings\n"
+            "  of the same size a level above and so on, until a single ring is left\n"
+            "  The latency of each level is logged at INFO\n"
+            "  Default 0 is one flat ring"
+    );
+    app.add_option(
+        "--segment-of",
+        config.segment_of,
+        "Size of a ring spread over processes, of which this ring is a segment\n"
+            "  The segment needs --listen, --next and the same --seed as the others\n"
+            "  Default 0 is a ring of its own"
+    );
+    app.add_option(
+        "--segment-start",
+        config.segment_start,
+        "Position of the segment's first worker in the ring spread over processes\n"
+            "  Only the segment at position 0 starts the elections\n"
+            "  Default is position 0"
+    );
+    app.add_option(
+        "--listen",
+        config.listen_endpoint,
+        "Endpoint on which the segment listens for the previous segment\n"
+            "  Either unix:<path>, tcp:<address>:<port> or shm:<name>"
+    );
+    app.add_option(
+        "--next",
+        config.next_endpoint,
+        "Endpoint of the next segment, to which the segment's last worker sends\n"
+            "  Either unix:<path>, tcp:<address>:<port> or shm:<name>"
+    );
+    app.add_flag(
+        "--simulate",
+        config.simulate,
+        "Simulates the elections deterministically on a virtual clock\n"
+            "  in a single thread instead of running the workers\n"
+            "  Only the log reports the simulated elections, at INFO by default"
+    );
+    app.add_option(
+        "--seed",
+        config.seed,
+        "Seed of the worker ids and of the simulated link jitter\n"
+            "  The same seed always results in the same ids and simulation\n"
+            "  Default 0 is a random seed for the ring and the seed 0 for the simulation"
+    );
+    app.add_option(
+        "--link-latency",
+        config.link_latency,
+        "Virtual time a simulated message takes to the next worker in microseconds\n"
+            "  Default is a latency of 100 microseconds"
+    );
+    app.add_option(
+        "--link-jitter",
+        config.link_jitter,
+        "Maximal virtual time added at random to each simulated hop in microseconds\n"
+            "  Default is no jitter"
+    );
     app.add_flag(
         "--log",
         config.logging_enabled,
@@ -105,9 +297,55 @@ ConfigExit configure(int argc, char* argv[], Config& config) {
         CLI11_PARSE(app, argc, argv);
     }
 
+    // one of them may come from the config file and the other from the CLI
+    if (config.use_tasks && config.use_shards) {
+        cerr << "The workers run either as tasks or in shards, not both\n"
+             << "Run with --help for more information." << endl;
+        return (int)CLI::ExitCodes::ValidationError;
+    }
+
+    if (config.segment_of > 0) {
+        if (config.listen_endpoint == "" || config.next_endpoint == "" || config.seed == 0) {
+            cerr << "A segment of a ring needs --listen, --next and a --seed other than 0\n"
+                 << "Run with --help for more information." << endl;
+            return (int)CLI::ExitCodes::RequiredError;
+        }
+        if (config.segment_start + config.number_of_workers > config.segment_of) {
+            cerr << "The segment doesn't fit into the ring of size " << config.segment_of << "\n"
+                 << "Run with --help for more information." << endl;
+            return (int)CLI::ExitCodes::ValidationError;
+        }
+        if (config.election_algorithm != ElectionAlgorithm::chang_roberts) {
+            cerr << "A segment of a ring only elects with chang-roberts\n"
+                 << "Run with --help for more information." << endl;
+            return (int)CLI::ExitCodes::ValidationError;
+        }
+        if (config.number_of_initiators != 1) {
+            cerr << "A segment of a ring is only started by the first worker of the ring\n"
+                 << "Run with --help for more information." << endl;
+            return (int)CLI::ExitCodes::ValidationError;
+        }
+        if (config.sub_ring_size > 0) {
+            cerr << "A segment of a ring can't be split into sub-rings\n"
+                 << "Run with --help for more information." << endl;
+            return (int)CLI::ExitCodes::ValidationError;
+        }
+        if (config.closed_loop) {
+            cerr << "A segment of a ring can't run elections in a closed loop, "
+                    "as the leader's segment completes them\n"
+                 << "Run with --help for more information." << endl;
+            return (int)CLI::ExitCodes::ValidationError;
+        }
+        if (get_endpoint_scheme(config.listen_endpoint) != get_endpoint_scheme(config.next_endpoint)) {
+            cerr << "The endpoints --listen and --next need to be of the same kind\n"
+                 << "Run with --help for more information." << endl;
+            return (int)CLI::ExitCodes::ValidationError;
+        }
+    }
+
     config.is_file_logger = config.log_file_name != "";
 
-    if ((config.logging_enabled || config.is_file_logger) 
+    if ((config.logging_enabled || config.is_file_logger || config.simulate) 
             && 
          config.logging_level == spdlog::level::off
     ) {
@@ -130,9 +368,112 @@ int get_file_config(const string& file_name, Config& config) {
         config.after_election_sleeptime = 
             file_config["ring"]["sleeptime"]
             .value_or(config.after_election_sleeptime);
+        config.closed_loop = 
+            file_config["ring"]["closed_loop"]
+            .value_or(config.closed_loop);
+        config.use_tasks = 
+            file_config["ring"]["tasks"]
+            .value_or(config.use_tasks);
+        config.use_shards = 
+            file_config["ring"]["shards"]
+            .value_or(config.use_shards);
+        if (config.use_tasks && config.use_shards) {
+            cerr << "The config file runs the workers both as tasks and in shards, "
+                    "only one of them is possible." << endl;
+            return 3;
+        }
+        config.task_threads = 
+            file_config["ring"]["task_threads"]
+            .value_or(config.task_threads);
+        config.stack_size = 
+            file_config["ring"]["stack_size"]
+            .value_or(config.stack_size);
+        config.stop_deadline = 
+            file_config["ring"]["stop_deadline"]
+            .value_or(config.stop_deadline);
+        config.sub_ring_size = 
+            file_config["ring"]["sub_ring_size"]
+            .value_or(config.sub_ring_size);
+        config.number_of_initiators = 
+            file_config["ring"]["initiators"]
+            .value_or(config.number_of_initiators);
+        config.seed = 
+            file_config["ring"]["seed"]
+            .value_or(config.seed);
+
+        string placement{
+            file_config["ring"]["placement"]
+            .value_or(to_string(config.placement))
+        };
+        if (!placement_from_string(placement, config.placement)) {
+            cerr << "The placement \"" << placement 
+                 << "\" in the config file is none of none, compact and scatter." << endl;
+            return 3;
+        }
+
+        string election_algorithm{
+            file_config["ring"]["election"]
+            .value_or(to_string(config.election_algorithm))
+        };
+        if (!election_algorithm_from_string(election_algorithm, config.election_algorithm)) {
+            cerr << "The election \"" << election_algorithm 
+                 << "\" in the config file is none of chang-roberts, hirschberg-sinclair and peterson." << endl;
+            return 3;
+        }
+
+        string id_layout{
+            file_config["ring"]["id_layout"]
+            .value_or(to_string(config.id_layout))
+        };
+        if (!id_layout_from_string(id_layout, config.id_layout)) {
+            cerr << "The id layout \"" << id_layout 
+                 << "\" in the config file is none of random, ascending, descending and adversarial." << endl;
+            return 3;
+        }
         config.worker_sleeptime = 
             file_config["ring"]["worker"]["sleeptime"]
             .value_or(config.worker_sleeptime);
+        config.mailbox_capacity = 
+            file_config["ring"]["worker"]["mailbox_capacity"]
+            .value_or(config.mailbox_capacity);
+        config.batch_limit = 
+            file_config["ring"]["worker"]["batch_limit"]
+            .value_or(config.batch_limit);
+        // a mailbox or batch must hold at least one Message
+        if (config.mailbox_capacity == 0) {
+            cerr << "The mailbox capacity in the config file needs to be positive." << endl;
+            return 3;
+        }
+        if (config.batch_limit == 0) {
+            cerr << "The batch limit in the config file needs to be positive." << endl;
+            return 3;
+        }
+        config.worker_spin_limit = 
+            file_config["ring"]["worker"]["spin_limit"]
+            .value_or(config.worker_spin_limit);
+
+        config.segment_of = 
+            file_config["segment"]["ring_size"]
+            .value_or(config.segment_of);
+        config.segment_start = 
+            file_config["segment"]["start"]
+            .value_or(config.segment_start);
+        config.listen_endpoint = 
+            file_config["segment"]["listen"]
+            .value_or(config.listen_endpoint);
+        config.next_endpoint = 
+            file_config["segment"]["next"]
+            .value_or(config.next_endpoint);
+
+        config.simulate = 
+            file_config["simulation"]["enabled"]
+            .value_or(config.simulate);
+        config.link_latency = 
+            file_config["simulation"]["link_latency"]
+            .value_or(config.link_latency);
+        config.link_jitter = 
+            file_config["simulation"]["link_jitter"]
+            .value_or(config.link_jitter);
 
         config.logging_enabled = 
             file_config["log"]["enabled"]
@@ -217,6 +558,11 @@ void write_log_start(shared_ptr<spdlog::logger>& logger) {
     logger->info("=========================================================");
 }
 
+// The kind of endpoint, which is everything before the first ':'
+string get_endpoint_scheme(const string& endpoint) {
+    return endpoint.substr(0, endpoint.find(':'));
+}
+
 shared_ptr<spdlog::logger> get_console_logger() {
     auto logger{spdlog::stdout_logger_mt("logger")};
 
@@ -232,7 +578,29 @@ Config::operator string() const {
            << "Config File:                " << config_file              << "\n"
            << "Number of Elections:        " << number_of_elections      << "\n"
            << "Sleeptime:                  " << after_election_sleeptime << " ms\n"
+           << "Closed Loop:                " << closed_loop              << "\n"
            << "Worker Sleeptime:           " << worker_sleeptime         << " ms\n"
+           << "Worker Mailbox Capacity:    " << mailbox_capacity         << "\n"
+           << "Worker Batch Limit:         " << batch_limit              << "\n"
+           << "Worker Spin Limit:          " << worker_spin_limit        << "\n"
+           << "Workers as Tasks:           " << use_tasks                << "\n"
+           << "Workers in Shards:          " << use_shards               << "\n"
+           << "Task Threads:               " << task_threads             << "\n"
+           << "Stack Size:                 " << stack_size               << " KiB\n"
+           << "Stop Deadline:              " << stop_deadline            << " ms\n"
+           << "Placement:                  " << to_string(placement)     << "\n"
+           << "Election:                   " << to_string(election_algorithm) << "\n"
+           << "Id Layout:                  " << to_string(id_layout)     << "\n"
+           << "Initiators:                 " << number_of_initiators     << "\n"
+           << "Sub-Ring Size:              " << sub_ring_size            << "\n"
+           << "Seed:                       " << seed                     << "\n"
+           << "Segment of Ring of Size:    " << segment_of               << "\n"
+           << "Segment Start:              " << segment_start            << "\n"
+           << "Listen Endpoint:            " << listen_endpoint          << "\n"
+           << "Next Endpoint:              " << next_endpoint            << "\n"
+           << "Simulation:                 " << simulate                 << "\n"
+           << "Simulated Link Latency:     " << link_latency             << " µs\n"
+           << "Simulated Link Jitter:      " << link_jitter              << " µs\n"
            << "Logging enabled explicitly: " << logging_enabled          << "\n"
            << "Log File:                   " << log_file_name            << "\n"
            << "Log Dates in File:          " << log_date                 << "\n"
@@ -0,0 +1,33 @@
+#include "election_algorithm.h"
+
+using namespace std;
+
+
+string to_string(ElectionAlgorithm election_algorithm) {
+    switch (election_algorithm) {
+        case ElectionAlgorithm::hirschberg_sinclair:
+            return "hirschberg-sinclair";
+        case ElectionAlgorithm::peterson:
+            return "peterson";
+        default:
+            return "chang-roberts";
+    }
+}
+
+bool election_algorithm_from_string(
+    const string& name, 
+    ElectionAlgorithm& election_algorithm
+) {
+    for (ElectionAlgorithm candidate : {
+        ElectionAlgorithm::chang_roberts, 
+        ElectionAlgorithm::hirschberg_sinclair,
+        ElectionAlgorithm::peterson
+    }) {
+        if (name == to_string(candidate)) {
+            election_algorithm = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
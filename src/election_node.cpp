@@ -0,0 +1,325 @@
+#include "election_node.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+bool ElectionNode::enter_epoch(ElectionState& node, const Message& message) {
+    if (message.type != MessageType::StartElection 
+            && 
+        message.type != MessageType::StandIn 
+            && 
+        !is_election_message(message)
+    ) {
+        return true;
+    }
+    if (message.epoch == node.epoch) {
+        return true;
+    }
+    if (is_older_epoch(message.epoch, node.epoch)) {
+        return false;
+    }
+
+    node.epoch = message.epoch;
+    node.participates_in_election = false;
+    node.is_candidate = false;
+    node.leader_id = 0;
+
+    return true;
+}
+
+void ElectionNode::act_upon_election_message(ElectionState& node, const Message& message) {
+    switch (message.type) {
+        case MessageType::StartElection:
+            start_election(node);
+            break;
+        case MessageType::ElectionProposal:
+            participate_in_election(node, message);
+            break;
+        case MessageType::Elected:
+            end_election(node, message);
+            break;
+        case MessageType::Probe:
+            handle_probe(node, message);
+            break;
+        case MessageType::Reply:
+            handle_reply(node, message);
+            break;
+        case MessageType::Candidate:
+            handle_candidate(node, message);
+            break;
+        case MessageType::PreviousCandidate:
+            handle_previous_candidate(node, message);
+            break;
+        default:
+            break;
+    }
+}
+
+bool ElectionNode::has_level_above() const {
+    return false;
+}
+
+void ElectionNode::start_election(ElectionState& node) {
+    // An initiator, which a proposal has woken up already, takes part in the election
+    if (node.participates_in_election && election_algorithm != ElectionAlgorithm::hirschberg_sinclair) {
+        return;
+    }
+
+    presenter->worker_starts_election(node.id);
+
+    if (election_algorithm == ElectionAlgorithm::hirschberg_sinclair) {
+        join_probing(node);
+        return;
+    }
+    if (election_algorithm == ElectionAlgorithm::peterson) {
+        join_peterson_election(node);
+        return;
+    }
+
+    presenter->worker_participates_in_election(node.id);
+    node.participates_in_election = true;
+
+    propose_oneself(node);
+}
+
+void ElectionNode::participate_in_election(ElectionState& node, const Message& proposal) {
+    if (node.is_leader) {
+        presenter->worker_resigns_as_leader(node.id);
+        node.is_leader = false;
+    }
+
+    bool already_participated_in_election{node.participates_in_election};
+
+    if (!node.participates_in_election) {
+        node.participates_in_election = true;
+        presenter->worker_participates_in_election(node.id);
+    }
+
+    if (proposal.id > node.id) {
+        forward_election_proposal(node, proposal);
+    }
+    else if (proposal.id == node.id) {
+        be_elected(node);
+    }
+    else {
+        if (already_participated_in_election) {
+            presenter->worker_discards_election_proposal(node.id, proposal.id);
+        }
+        else {
+            propose_oneself(node);
+        }
+    }
+}
+
+void ElectionNode::forward_election_proposal(ElectionState& node, const Message& proposal) {
+    presenter->worker_forwards_election_proposal(node.id, proposal.id);
+    send_to_neighbour_of(node, proposal);
+}
+
+void ElectionNode::be_elected(ElectionState& node) {
+    presenter->worker_is_elected(node.id);
+    node.is_leader = true;
+    node.is_candidate = false;
+
+    presenter->worker_stops_election_participation(node.id);
+    node.participates_in_election = false;
+
+    send_to_neighbour_of(node, Message::elected(node.id));
+}
+
+void ElectionNode::propose_oneself(ElectionState& node) {
+    presenter->worker_proposes_itself_in_election(node.id);
+    send_to_neighbour_of(node, Message::election_proposal(node.id));
+}
+
+void ElectionNode::end_election(ElectionState& node, const Message& elected) {
+    if (elected.id == node.id) {
+        finish_election(node);
+        return;
+    }
+
+    if (has_level_above()) {
+        // The leader of the level above, which is announced to the leader of the ring,
+        // has gone around the whole ring, once it's back at the leader.
+        if (node.leader_id == elected.id) {
+            return;
+        }
+        if (node.is_leader) {
+            presenter->worker_resigns_as_leader(node.id);
+            node.is_leader = false;
+        }
+    }
+
+    node.leader_id = elected.id;
+    presenter->worker_stops_election_participation(node.id);
+    node.participates_in_election = false;
+
+    send_to_neighbour_of(node, elected);
+}
+
+// Every node starts a Hirschberg-Sinclair election as a candidate.
+void ElectionNode::join_probing(ElectionState& node) {
+    if (node.is_leader) {
+        presenter->worker_resigns_as_leader(node.id);
+        node.is_leader = false;
+    }
+
+    presenter->worker_participates_in_election(node.id);
+    node.participates_in_election = true;
+
+    node.is_candidate = true;
+    node.phase = 0;
+    node.number_of_replies = 0;
+    send_probes(node);
+}
+
+// Probes the 2^phase nodes on both sides,
+// the next phase starts once both probes are replied to.
+void ElectionNode::send_probes(ElectionState& node) {
+    presenter->worker_proposes_itself_in_election(node.id);
+
+    send_to_neighbour_of(node, Message::probe(node.id, node.phase, 1, false));
+    send_to_predecessor_of(node, Message::probe(node.id, node.phase, 1, true));
+}
+
+// Whether or not the node is a candidate,
+// only the probes of the highest id travel all around the Ring.
+// Joining on a probe instead of on the start would let stray probes,
+// which arrive after the Elected Message, start the election over and over.
+void ElectionNode::handle_probe(ElectionState& node, const Message& probe) {
+    if (probe.id == node.id) {
+        // It has gone around the whole Ring,
+        // the one from the other side follows and is dropped.
+        if (!node.is_leader) {
+            be_elected(node);
+        }
+        return;
+    }
+
+    if (probe.id < node.id) {
+        presenter->worker_discards_election_proposal(node.id, probe.id);
+        return;
+    }
+
+    node.is_candidate = false;
+
+    uint64_t distance{(uint64_t)1 << min<uint8_t>(probe.probing.phase, 63)};
+    if (probe.probing.hops < distance) {
+        presenter->worker_forwards_election_proposal(node.id, probe.id);
+        Message forwarded_probe{Message::probe(
+            probe.id, probe.probing.phase, probe.probing.hops + 1, probe.probing.is_backwards
+        )};
+
+        if (probe.probing.is_backwards) {
+            send_to_predecessor_of(node, forwarded_probe);
+        }
+        else {
+            send_to_neighbour_of(node, forwarded_probe);
+        }
+    }
+    else {
+        // the reply travels back the way the probe came
+        Message reply{Message::reply(probe.id, probe.probing.phase, !probe.probing.is_backwards)};
+
+        if (reply.probing.is_backwards) {
+            send_to_predecessor_of(node, reply);
+        }
+        else {
+            send_to_neighbour_of(node, reply);
+        }
+    }
+}
+
+void ElectionNode::handle_reply(ElectionState& node, const Message& reply) {
+    if (reply.id != node.id) {
+        if (reply.probing.is_backwards) {
+            send_to_predecessor_of(node, reply);
+        }
+        else {
+            send_to_neighbour_of(node, reply);
+        }
+        return;
+    }
+
+    // a node beaten meanwhile doesn't probe any further
+    if (node.is_candidate && reply.probing.phase == node.phase && ++node.number_of_replies == 2) {
+        node.phase++;
+        node.number_of_replies = 0;
+        send_probes(node);
+    }
+}
+
+// A node joins a Peterson election as an active node,
+// when it starts it or when the first Message of it reaches the node.
+// Since the Messages keep their order,
+// nothing of an election is left once its leader is known.
+void ElectionNode::join_peterson_election(ElectionState& node) {
+    if (node.is_leader) {
+        presenter->worker_resigns_as_leader(node.id);
+        node.is_leader = false;
+    }
+
+    presenter->worker_participates_in_election(node.id);
+    node.participates_in_election = true;
+
+    node.is_candidate = true;
+    node.candidate_id = node.id;
+    node.phase = 0;
+
+    presenter->worker_proposes_itself_in_election(node.id);
+    send_to_neighbour_of(node, Message::candidate(node.candidate_id, node.phase));
+}
+
+void ElectionNode::handle_candidate(ElectionState& node, const Message& candidate) {
+    if (!node.participates_in_election) {
+        join_peterson_election(node);
+    }
+    if (!node.is_candidate) {
+        relay(node, candidate);
+        return;
+    }
+
+    if (candidate.id == node.candidate_id) {
+        // It's the only active node left and its candidate the highest id,
+        // which is proposed until it reaches its node.
+        node.is_candidate = false;
+
+        if (node.candidate_id == node.id) {
+            be_elected(node);
+        }
+        else {
+            presenter->worker_forwards_election_proposal(node.id, node.candidate_id);
+            send_to_neighbour_of(node, Message::election_proposal(node.candidate_id));
+        }
+        return;
+    }
+
+    node.first_candidate_id = candidate.id;
+    send_to_neighbour_of(node, Message::previous_candidate(candidate.id, node.phase));
+}
+
+// The node stays active for the candidate before it,
+// if that's higher than its own and the one before.
+void ElectionNode::handle_previous_candidate(ElectionState& node, const Message& previous_candidate) {
+    if (!node.is_candidate) {
+        relay(node, previous_candidate);
+        return;
+    }
+
+    if (node.first_candidate_id > node.candidate_id && node.first_candidate_id > previous_candidate.id) {
+        node.candidate_id = node.first_candidate_id;
+        node.phase++;
+        send_to_neighbour_of(node, Message::candidate(node.candidate_id, node.phase));
+    }
+    else {
+        presenter->worker_discards_election_proposal(node.id, node.candidate_id);
+        node.is_candidate = false;
+    }
+}
+
+void ElectionNode::relay(ElectionState& node, const Message& message) {
+    presenter->worker_forwards_election_proposal(node.id, message.id);
+    send_to_neighbour_of(node, message);
+}
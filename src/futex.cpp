@@ -0,0 +1,119 @@
+#include "futex.h"
+
+#include <climits>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#else
+#include <thread>
+#endif
+
+using namespace std;
+
+static_assert(
+    sizeof(atomic<uint32_t>) == sizeof(uint32_t) 
+        && 
+    atomic<uint32_t>::is_always_lock_free,
+    "a futex needs to be a plain 32 bit word"
+);
+
+
+#ifdef __linux__
+
+// Words shared between processes can't use the cheaper private futexes
+static long futex(
+    atomic<uint32_t>& word, 
+    int operation, 
+    uint32_t value, 
+    const timespec* timeout, 
+    bool is_shared
+) {
+    return syscall(
+        SYS_futex, 
+        reinterpret_cast<uint32_t*>(&word), 
+        is_shared ? operation : operation | FUTEX_PRIVATE_FLAG, 
+        value, 
+        timeout, 
+        nullptr, 
+        0
+    );
+}
+
+void futex_wait(atomic<uint32_t>& word, uint32_t expected) {
+    futex(word, FUTEX_WAIT, expected, nullptr, false);
+}
+
+static timespec to_timespec(chrono::nanoseconds timeout) {
+    auto seconds{chrono::duration_cast<chrono::seconds>(timeout)};
+    return timespec{
+        (time_t)seconds.count(), 
+        (long)(timeout - seconds).count()
+    };
+}
+
+void futex_wait_for(atomic<uint32_t>& word, uint32_t expected, chrono::nanoseconds timeout) {
+    if (timeout.count() <= 0) {
+        return;
+    }
+
+    timespec relative_timeout{to_timespec(timeout)};
+    futex(word, FUTEX_WAIT, expected, &relative_timeout, false);
+}
+
+void futex_wait_for_shared(atomic<uint32_t>& word, uint32_t expected, chrono::nanoseconds timeout) {
+    if (timeout.count() <= 0) {
+        return;
+    }
+
+    timespec relative_timeout{to_timespec(timeout)};
+    futex(word, FUTEX_WAIT, expected, &relative_timeout, true);
+}
+
+void futex_wake_one(atomic<uint32_t>& word) {
+    futex(word, FUTEX_WAKE, 1, nullptr, false);
+}
+
+void futex_wake_all(atomic<uint32_t>& word) {
+    futex(word, FUTEX_WAKE, INT_MAX, nullptr, false);
+}
+
+void futex_wake_all_shared(atomic<uint32_t>& word) {
+    futex(word, FUTEX_WAKE, INT_MAX, nullptr, true);
+}
+
+#else
+
+// The polling interval used instead of a real futex
+constexpr chrono::microseconds polling_interval{50};
+
+void futex_wait(atomic<uint32_t>& word, uint32_t expected) {
+    while (word.load(memory_order_acquire) == expected) {
+        this_thread::sleep_for(polling_interval);
+    }
+}
+
+void futex_wait_for(atomic<uint32_t>& word, uint32_t expected, chrono::nanoseconds timeout) {
+    auto deadline{chrono::steady_clock::now() + timeout};
+
+    while (word.load(memory_order_acquire) == expected 
+            && 
+           chrono::steady_clock::now() < deadline
+    ) {
+        this_thread::sleep_for(polling_interval);
+    }
+}
+
+void futex_wake_one(atomic<uint32_t>&) {}
+
+void futex_wake_all(atomic<uint32_t>&) {}
+
+void futex_wait_for_shared(atomic<uint32_t>& word, uint32_t expected, chrono::nanoseconds timeout) {
+    futex_wait_for(word, expected, timeout);
+}
+
+void futex_wake_all_shared(atomic<uint32_t>&) {}
+
+#endif
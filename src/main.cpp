@@ -1,13 +1,21 @@
 #include "ring.h"
+#include "simulation.h"
+#include "transport.h"
 #include "config.h"
 
+#include <future>
+#include <memory>
+#include <optional>
 #include <thread>
 #include <chrono>
 
 using namespace std;
 
 void run_ring(const Config&, Presenter*);
+void run_simulation(const Config&, Presenter*);
 void cycle(Ring&, chrono::milliseconds);
+optional<ElectionResult> closed_loop_cycle(Ring&, chrono::milliseconds);
+void run_closed_loop(Ring&, const Config&, Presenter*);
 
 
 int main(int argc, char* argv[]) {
@@ -20,19 +28,61 @@ int main(int argc, char* argv[]) {
 
     Presenter* presenter = get_and_start_presenter(config);
     
-    run_ring(config, presenter);
+    if (config.simulate) {
+        run_simulation(config, presenter);
+    }
+    else {
+        run_ring(config, presenter);
+    }
 
     delete presenter;
 }
 
 
 void run_ring(const Config& config, Presenter* presenter) {
-    Ring ring(config.number_of_workers, config.worker_sleeptime, presenter);
+    Ring ring(
+        config.number_of_workers, 
+        config.worker_sleeptime, 
+        presenter,
+        WorkerOptions{
+            config.mailbox_capacity, 
+            config.batch_limit, 
+            config.worker_spin_limit,
+            config.election_algorithm
+        },
+        ExecutionOptions{
+            config.use_tasks, 
+            config.use_shards, 
+            config.task_threads, 
+            config.stop_deadline,
+            config.placement
+        },
+        SetupOptions{
+            config.seed, 
+            config.stack_size * 1024, 
+            config.segment_start, 
+            config.segment_of,
+            config.sub_ring_size,
+            config.id_layout,
+            config.number_of_initiators
+        }
+    );
+
+    if (config.segment_of > 0) {
+        ring.connect(make_transport(
+            config.listen_endpoint, 
+            config.next_endpoint, 
+            presenter
+        ));
+    }
 
     ring.start();
     
     chrono::milliseconds sleeptime{config.after_election_sleeptime};
-    if (config.number_of_elections > 0) {
+    if (config.closed_loop) {
+        run_closed_loop(ring, config, presenter);
+    }
+    else if (config.number_of_elections > 0) {
         for (unsigned int i{0}; i < config.number_of_elections; i++) {
             cycle(ring, sleeptime);
         }
@@ -46,7 +96,76 @@ void run_ring(const Config& config, Presenter* presenter) {
     ring.stop();
 }
 
+void run_simulation(const Config& config, Presenter* presenter) {
+    Simulation simulation(
+        config.number_of_workers, 
+        config.worker_sleeptime, 
+        presenter,
+        SimulationOptions{
+            config.seed, 
+            config.link_latency, 
+            config.link_jitter, 
+            config.election_algorithm,
+            config.id_layout,
+            config.number_of_initiators
+        }
+    );
+
+    // a simulation doesn't run forever, so it's at least one election
+    unsigned int number_of_elections{max(1u, config.number_of_elections)};
+    for (unsigned int i{0}; i < number_of_elections; i++) {
+        simulation.simulate_election();
+    }
+}
+
 void cycle(Ring& ring, chrono::milliseconds sleeptime) {
     ring.start_election();
     this_thread::sleep_for(sleeptime);
 }
+
+// Starts an election and waits until it has completed, at most for the timeout;
+// the next election supersedes one which hasn't.
+optional<ElectionResult> closed_loop_cycle(Ring& ring, chrono::milliseconds timeout) {
+    future<ElectionResult> election{ring.start_election()};
+
+    if (!election.valid()) {
+        // the Ring isn't running, since segments are rejected for a closed loop,
+        // so there's nothing to wait for
+        return {};
+    }
+    if (election.wait_for(timeout) != future_status::ready) {
+        return {};
+    }
+
+    return election.get();
+}
+
+// Starts each election as soon as the one before has completed
+// and reports the throughput of the given number of elections.
+void run_closed_loop(Ring& ring, const Config& config, Presenter* presenter) {
+    chrono::milliseconds timeout{config.after_election_sleeptime};
+
+    if (config.number_of_elections == 0) {
+        while (true) {
+            closed_loop_cycle(ring, timeout);
+        }
+    }
+
+    size_t number_of_completed_elections{0};
+    size_t number_of_messages{0};
+    auto start{chrono::steady_clock::now()};
+
+    for (unsigned int i{0}; i < config.number_of_elections; i++) {
+        if (optional<ElectionResult> result{closed_loop_cycle(ring, timeout)}) {
+            number_of_completed_elections++;
+            number_of_messages += result->number_of_messages;
+        }
+    }
+
+    presenter->elections_completed(
+        config.number_of_elections,
+        number_of_completed_elections,
+        number_of_messages,
+        chrono::duration<double, milli>(chrono::steady_clock::now() - start).count()
+    );
+}
@@ -0,0 +1,91 @@
+#include "membership.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+
+Membership::Membership(
+    vector<Worker*> workers, 
+    uint64_t version
+): workers{move(workers)}, 
+   version{version} 
+{}
+
+size_t Membership::size() const {
+    return workers.size();
+}
+
+Worker* Membership::at(unsigned int position) const {
+    return workers[position % workers.size()];
+}
+
+
+SharedMembership::SharedMembership(vector<Worker*> workers) {
+    if (workers.empty()) {
+        throw invalid_argument("There must be at least one Worker in a Membership.");
+    }
+
+    current = make_shared<const Membership>(move(workers));
+}
+
+uint64_t SharedMembership::get_version() const {
+    return current_version.load(memory_order_acquire);
+}
+
+shared_ptr<const Membership> SharedMembership::get() {
+    lock_guard<mutex> membership_lck{membership_mtx};
+    return current;
+}
+
+shared_ptr<const Membership> SharedMembership::get_since(
+    uint64_t version, 
+    vector<MembershipChange>& changes
+) {
+    lock_guard<mutex> membership_lck{membership_mtx};
+    changes.insert(changes.end(), this->changes.begin() + version, this->changes.end());
+    return current;
+}
+
+bool SharedMembership::remove(Worker* worker) {
+    lock_guard<mutex> membership_lck{membership_mtx};
+
+    auto it{find(current->workers.begin(), current->workers.end(), worker)};
+    if (it == current->workers.end() || current->size() == 1) {
+        return false;
+    }
+
+    unsigned int position{(unsigned int)(it - current->workers.begin())};
+    vector<Worker*> workers{current->workers};
+    workers.erase(workers.begin() + position);
+
+    publish(move(workers), MembershipChange{false, position, worker});
+
+    return true;
+}
+
+bool SharedMembership::insert(unsigned int position, Worker* worker) {
+    lock_guard<mutex> membership_lck{membership_mtx};
+
+    auto it{find(current->workers.begin(), current->workers.end(), worker)};
+    if (it != current->workers.end()) {
+        return false;
+    }
+
+    position = min(position, (unsigned int)current->size());
+    vector<Worker*> workers{current->workers};
+    workers.insert(workers.begin() + position, worker);
+
+    publish(move(workers), MembershipChange{true, position, worker});
+
+    return true;
+}
+
+// Replaces the current version, which is freed unless a Worker still holds it,
+// and logs the change before the new version number is published.
+void SharedMembership::publish(vector<Worker*> workers, MembershipChange change) {
+    current = make_shared<const Membership>(move(workers), current->version + 1);
+    changes.push_back(change);
+    current_version.store(current->version, memory_order_release);
+}
@@ -1,53 +1,243 @@
 #include "message_buffer.h"
+#include "futex.h"
 
-#include <thread>
 #include <chrono>
+#include <thread>
 
 using namespace std;
 
+// The parts of the single slot's state word
+constexpr uint32_t slot_mask{0b11};
+constexpr uint32_t slot_empty{0b00};
+constexpr uint32_t slot_claimed{0b01};
+constexpr uint32_t slot_full{0b10};
+constexpr uint32_t waiters_flag{0b100};
+constexpr uint32_t take_count_mask{~(slot_mask | waiters_flag)};
+constexpr uint32_t take_count_increment{0b1000};
+
+// Looked up once, because it's a system call and there may be millions of Buffers
+static bool has_multiple_cores() {
+    static const bool has_multiple_cores{thread::hardware_concurrency() > 1};
+    return has_multiple_cores;
+}
 
-bool MessageBuffer::assign_and_wait(Message* message, unsigned int waittime) {
-    // only one thread at a time is allowed to be in this method
-    lock_guard<mutex> assign_and_wait_lck{assign_and_wait_mtx};
 
-    unique_lock<mutex> rendezvous_lck{rendezvous_mtx}; 
-    message_is_taken = false;
-    rendezvous_lck.unlock();
+MessageBuffer::MessageBuffer(
+    size_t capacity, 
+    unsigned int spin_limit
+): // with a single core spinning only delays the thread which would assign
+   spin_limit{has_multiple_cores() ? spin_limit : 0}
+{
+    if (capacity > 1) {
+        queue = make_unique<MessageQueue>(capacity, this->spin_limit);
+    }
+}
 
-    // rendezvous_lck beeing locked during assignment could cause a deadlock 
-    //      in combination with another assign call and take
-    assign(message);
+bool MessageBuffer::assign_and_wait(const Message& message, unsigned int waittime) {
+    if (queue) {
+        return queue->push_and_wait(message, waittime);
+    }
 
-    rendezvous_lck.lock();
-    return message_taken.wait_for(
-        rendezvous_lck, chrono::milliseconds(waittime), 
-        [this](){ return message_is_taken; }
-    );
+    uint32_t observed_state{state.load(memory_order_relaxed)};
+    claim_slot(observed_state, chrono::steady_clock::time_point::max());
+    uint32_t take_count{fill_slot(message, observed_state)};
+    auto deadline{chrono::steady_clock::now() + chrono::milliseconds(waittime)};
+
+    // the Message is taken with the next take, which increases the take count
+    observed_state = state.load(memory_order_acquire);
+    while ((observed_state & take_count_mask) == take_count) {
+        if (chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+
+        wait_on_state_until(observed_state, deadline);
+        observed_state = state.load(memory_order_acquire);
+    }
+
+    return true;
+}
+
+void MessageBuffer::assign(const Message& message) {
+    if (queue) {
+        queue->push(message);
+        return;
+    }
+
+    uint32_t observed_state{state.load(memory_order_relaxed)};
+    claim_slot(observed_state, chrono::steady_clock::time_point::max());
+    fill_slot(message, observed_state);
+}
+
+bool MessageBuffer::assign_until(
+    const Message& message, 
+    chrono::steady_clock::time_point deadline, 
+    DeliveryTicket& ticket
+) {
+    if (queue) {
+        size_t position;
+        bool is_assigned{queue->push_until(message, deadline, position)};
+        ticket = position;
+
+        return is_assigned;
+    }
+
+    uint32_t observed_state{state.load(memory_order_relaxed)};
+    if (!claim_slot(observed_state, deadline)) {
+        return false;
+    }
+    ticket = fill_slot(message, observed_state);
+
+    return true;
 }
 
-void MessageBuffer::assign(Message* message) {
-    unique_lock<mutex> buffer_lck{buffer_mtx};
-    message_assignable.wait(buffer_lck, [this](){ return is_empty(); });
+bool MessageBuffer::is_taken(DeliveryTicket ticket) {
+    if (queue) {
+        return queue->is_taken(ticket);
+    }
 
+    return (state.load(memory_order_acquire) & take_count_mask) != ticket;
+}
+
+bool MessageBuffer::claim_slot(
+    uint32_t& observed_state, 
+    chrono::steady_clock::time_point deadline
+) {
+    // claim the empty slot, so no other thread can write to it
+    while (true) {
+        if ((observed_state & slot_mask) == slot_empty) {
+            if (state.compare_exchange_weak(
+                    observed_state, observed_state | slot_claimed, 
+                    memory_order_acquire, memory_order_relaxed)
+            ) {
+                observed_state |= slot_claimed;
+                return true;
+            }
+        }
+        else if (deadline == chrono::steady_clock::time_point::max()) {
+            wait_on_state(observed_state);
+            observed_state = state.load(memory_order_relaxed);
+        }
+        else if (chrono::steady_clock::now() < deadline) {
+            wait_on_state_until(observed_state, deadline);
+            observed_state = state.load(memory_order_relaxed);
+        }
+        else {
+            return false;
+        }
+    }
+}
+
+// Writes the Message into the claimed slot and returns the take count,
+// which is increased when this Message is taken.
+uint32_t MessageBuffer::fill_slot(const Message& message, uint32_t observed_state) {
     this->message = message;
-    message_assigned = true;
-    message_takable.notify_one();
+
+    publish_state(
+        observed_state, 
+        (observed_state & take_count_mask) | slot_full
+    );
+
+    return observed_state & take_count_mask;
 }
 
-Message* MessageBuffer::take() {
-    unique_lock<mutex> buffer_lck{buffer_mtx};
-    message_takable.wait(buffer_lck, [this](){ return message_assigned; });
+Message MessageBuffer::take() {
+    if (queue) {
+        return queue->take();
+    }
+
+    uint32_t observed_state{state.load(memory_order_acquire)};
+    for (unsigned int i{0}; 
+         i < spin_limit && (observed_state & slot_mask) != slot_full; 
+         i++
+    ) {
+        cpu_relax();
+        observed_state = state.load(memory_order_acquire);
+    }
 
-    message_assigned = false;
-    message_assignable.notify_one();
+    while ((observed_state & slot_mask) != slot_full) {
+        wait_on_state(observed_state);
+        observed_state = state.load(memory_order_acquire);
+    }
 
-    lock_guard<mutex> rendezvous_lck{rendezvous_mtx};
-    message_is_taken = true;
-    message_taken.notify_one();
+    Message message{this->message};
+
+    publish_state(
+        observed_state, 
+        ((observed_state & take_count_mask) + take_count_increment) | slot_empty
+    );
 
     return message;
 }
 
+size_t MessageBuffer::take_all(vector<Message>& messages, size_t limit) {
+    if (queue) {
+        return queue->take_all(messages, limit);
+    }
+
+    messages.push_back(take());
+    return 1;
+}
+
+size_t MessageBuffer::try_take_all(vector<Message>& messages, size_t limit) {
+    if (queue) {
+        return queue->try_take_all(messages, limit);
+    }
+
+    // only the taking thread empties a full slot, so take doesn't block
+    if (limit == 0 || (state.load(memory_order_acquire) & slot_mask) != slot_full) {
+        return 0;
+    }
+
+    messages.push_back(take());
+    return 1;
+}
+
+void MessageBuffer::wait_on_state(uint32_t observed_state) {
+    // announce the waiting, so the next change of the state wakes this thread
+    uint32_t waiting_state{observed_state | waiters_flag};
+    if (observed_state == waiting_state 
+            || 
+        state.compare_exchange_strong(observed_state, waiting_state, memory_order_relaxed)
+    ) {
+        futex_wait(state, waiting_state);
+    }
+}
+
+void MessageBuffer::wait_on_state_until(
+    uint32_t observed_state, 
+    chrono::steady_clock::time_point deadline
+) {
+    uint32_t waiting_state{observed_state | waiters_flag};
+    if (observed_state == waiting_state 
+            || 
+        state.compare_exchange_strong(observed_state, waiting_state, memory_order_relaxed)
+    ) {
+        futex_wait_for(state, waiting_state, deadline - chrono::steady_clock::now());
+    }
+}
+
+void MessageBuffer::publish_state(uint32_t& observed_state, uint32_t new_state) {
+    while (!state.compare_exchange_weak(
+            observed_state, new_state, 
+            memory_order_acq_rel, memory_order_relaxed)
+    ) {
+        // Only waiters can have changed the state in the meantime 
+        // by setting their flag, which is cleared since all of them are woken.
+    }
+
+    if (observed_state & waiters_flag) {
+        futex_wake_all(state);
+    }
+}
+
 bool MessageBuffer::is_empty() {
-    return !message_assigned;
+    if (queue) {
+        return queue->is_empty();
+    }
+
+    return (state.load(memory_order_acquire) & slot_mask) != slot_full;
+}
+
+size_t MessageBuffer::get_capacity() const {
+    return queue ? queue->get_capacity() : 1;
 }
@@ -0,0 +1,227 @@
+#include "message_queue.h"
+#include "futex.h"
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+using namespace std;
+
+
+MessageQueue::MessageQueue(
+    size_t capacity,
+    unsigned int spin_limit
+): capacity{round_up_to_power_of_2(capacity)},
+   spin_limit{spin_limit},
+   cells{new Cell[this->capacity]}
+{
+    for (size_t i{0}; i < this->capacity; i++) {
+        cells[i].sequence.store(i, memory_order_relaxed);
+    }
+}
+
+void MessageQueue::push(const Message& message) {
+    size_t position;
+    while (!try_push(message, position)) {
+        this_thread::yield();
+    }
+    wake_consumer();
+}
+
+bool MessageQueue::push_and_wait(const Message& message, unsigned int waittime) {
+    size_t position;
+    while (!try_push(message, position)) {
+        this_thread::yield();
+    }
+
+    // registered before waking the consumer, so its take can't be missed
+    take_waiters.fetch_add(1);
+    atomic_thread_fence(memory_order_seq_cst);
+    wake_consumer();
+
+    auto deadline{chrono::steady_clock::now() + chrono::milliseconds(waittime)};
+    bool is_taken{false};
+    while (true) {
+        // loaded before checking, so a take in between changes it
+        uint32_t observed_signal{take_signal.load(memory_order_acquire)};
+
+        if (dequeue_position.load(memory_order_acquire) > position) {
+            is_taken = true;
+            break;
+        }
+
+        auto now{chrono::steady_clock::now()};
+        if (now >= deadline) {
+            break;
+        }
+
+        futex_wait_for(take_signal, observed_signal, deadline - now);
+    }
+    take_waiters.fetch_sub(1);
+
+    return is_taken;
+}
+
+bool MessageQueue::push_until(
+    const Message& message, 
+    chrono::steady_clock::time_point deadline, 
+    size_t& position
+) {
+    while (!try_push(message, position)) {
+        if (chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        this_thread::yield();
+    }
+    wake_consumer();
+
+    return true;
+}
+
+bool MessageQueue::is_taken(size_t position) const {
+    return dequeue_position.load(memory_order_acquire) > position;
+}
+
+Message MessageQueue::take() {
+    Message message{pop_or_park()};
+
+    wake_take_waiters();
+
+    return message;
+}
+
+size_t MessageQueue::take_all(vector<Message>& messages, size_t limit) {
+    messages.push_back(pop_or_park());
+    size_t number_of_messages{1};
+
+    Message message;
+    while (number_of_messages < limit && try_pop(message)) {
+        messages.push_back(message);
+        number_of_messages++;
+    }
+
+    // one notification for the whole batch
+    wake_take_waiters();
+
+    return number_of_messages;
+}
+
+size_t MessageQueue::try_take_all(vector<Message>& messages, size_t limit) {
+    size_t number_of_messages{0};
+
+    Message message;
+    while (number_of_messages < limit && try_pop(message)) {
+        messages.push_back(message);
+        number_of_messages++;
+    }
+
+    if (number_of_messages > 0) {
+        wake_take_waiters();
+    }
+
+    return number_of_messages;
+}
+
+Message MessageQueue::pop_or_park() {
+    Message message;
+
+    // a Message which arrives within the spin limit is taken without a syscall
+    for (unsigned int i{0}; i < spin_limit; i++) {
+        if (try_pop(message)) {
+            return message;
+        }
+        cpu_relax();
+    }
+
+    while (!try_pop(message)) {
+        consumer_parked.store(1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+
+        if (is_empty()) {
+            futex_wait(consumer_parked, 1);
+        }
+        consumer_parked.store(0, memory_order_relaxed);
+    }
+
+    return message;
+}
+
+bool MessageQueue::try_push(const Message& message, size_t& position) {
+    position = enqueue_position.load(memory_order_relaxed);
+    Cell* cell;
+
+    while (true) {
+        cell = &cells[position & (capacity - 1)];
+        size_t sequence{cell->sequence.load(memory_order_acquire)};
+        auto difference{(intptr_t)sequence - (intptr_t)position};
+
+        if (difference == 0) {
+            // the cell is free, try to reserve it
+            if (enqueue_position.compare_exchange_weak(
+                    position, position + 1, memory_order_relaxed)
+            ) {
+                break;
+            }
+        }
+        else if (difference < 0) {
+            return false; // the queue is full
+        }
+        else {
+            // another producer reserved the cell in the meantime
+            position = enqueue_position.load(memory_order_relaxed);
+        }
+    }
+
+    cell->message = message;
+    cell->sequence.store(position + 1, memory_order_release);
+
+    return true;
+}
+
+bool MessageQueue::try_pop(Message& message) {
+    size_t position{dequeue_position.load(memory_order_relaxed)};
+    Cell& cell{cells[position & (capacity - 1)]};
+
+    if (cell.sequence.load(memory_order_acquire) != position + 1) {
+        return false; // the queue is empty or the cell isn't written yet
+    }
+
+    message = cell.message;
+    cell.sequence.store(position + capacity, memory_order_release);
+    dequeue_position.store(position + 1, memory_order_release);
+
+    return true;
+}
+
+void MessageQueue::wake_consumer() {
+    // pairs with the fence in take,
+    // either the consumer sees the Message or it's seen as parked
+    atomic_thread_fence(memory_order_seq_cst);
+
+    if (consumer_parked.load(memory_order_relaxed)) {
+        consumer_parked.store(0, memory_order_relaxed);
+        futex_wake_one(consumer_parked);
+    }
+}
+
+void MessageQueue::wake_take_waiters() {
+    atomic_thread_fence(memory_order_seq_cst);
+
+    if (take_waiters.load(memory_order_relaxed) > 0) {
+        take_signal.fetch_add(1, memory_order_release);
+        futex_wake_all(take_signal);
+    }
+}
+
+bool MessageQueue::is_empty() const {
+    size_t position{dequeue_position.load(memory_order_relaxed)};
+
+    return
+        cells[position & (capacity - 1)].sequence.load(memory_order_acquire)
+            !=
+        position + 1;
+}
+
+size_t MessageQueue::get_capacity() const {
+    return capacity;
+}
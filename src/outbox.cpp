@@ -0,0 +1,419 @@
+#include "outbox.h"
+#include "worker.h"
+
+#include <algorithm>
+
+using namespace std;
+
+// how long the sender waits for space at a time, before it checks if it's stopped
+constexpr chrono::milliseconds stop_check_interval{10};
+
+
+void Outbox::start(size_t stack_size) {
+    lock_guard<mutex> outbox_lck{outbox_mtx};
+
+    if (!running) {
+        running = true;
+        has_sender = true;
+        sender = SizedThread{stack_size, [this](){ deliver(); }};
+    }
+}
+
+void Outbox::start_without_sender() {
+    lock_guard<mutex> outbox_lck{outbox_mtx};
+
+    running = true;
+    has_sender = false;
+}
+
+void Outbox::stop() {
+    unique_lock<mutex> outbox_lck{outbox_mtx};
+    running = false;
+    delivery_queued.notify_one();
+    outbox_lck.unlock();
+
+    if (sender.joinable()) {
+        sender.join();
+    }
+
+    unique_lock<mutex> pending_lck{pending_mtx};
+    while (first_pending_delivery) {
+        PendingDelivery* pending_delivery{first_pending_delivery};
+        first_pending_delivery = pending_delivery->next;
+
+        TimingWheel::get_instance().cancel(pending_delivery->timer);
+        ObjectPool<PendingDelivery>::destroy(pending_delivery);
+    }
+    last_pending_delivery = nullptr;
+    pending_lck.unlock();
+
+    outbox_lck.lock();
+    while (first_delivery) {
+        Delivery* delivery{first_delivery};
+        first_delivery = delivery->next;
+
+        delivery->message.dispose();
+        ObjectPool<Delivery>::destroy(delivery);
+    }
+    last_delivery = nullptr;
+
+    dispose_failed_deliveries(failed_deliveries);
+    dispose_failed_deliveries(taken_failed_deliveries);
+}
+
+void Outbox::send(Worker* receiver, const Message& message) {
+    if (has_sender) {
+        Delivery* delivery{
+            ObjectPool<Delivery>::create(Delivery{receiver, message, {}, nullptr})
+        };
+
+        lock_guard<mutex> outbox_lck{outbox_mtx};
+        queue_delivery(delivery);
+        delivery_queued.notify_one();
+
+        return;
+    }
+
+    settle_pending_deliveries();
+
+    auto deadline{
+        chrono::steady_clock::now() 
+            + 
+        chrono::milliseconds(receiver->get_delivery_waittime())
+    };
+
+    // only assigned right away when no Message is queued before it
+    if (first_delivery || !try_deliver(receiver, message, deadline)) {
+        queue_delivery(
+            ObjectPool<Delivery>::create(Delivery{receiver, message, deadline, nullptr})
+        );
+    }
+}
+
+bool Outbox::flush() {
+    settle_pending_deliveries();
+
+    auto now{chrono::steady_clock::now()};
+    while (first_delivery) {
+        Delivery* delivery{first_delivery};
+
+        if (!try_deliver(delivery->receiver, delivery->message, delivery->deadline)) {
+            if (delivery->deadline > now) {
+                break;
+            }
+
+            // there was no space for the Message until the deadline
+            report_failed_delivery(delivery->receiver, delivery->message);
+        }
+
+        first_delivery = delivery->next;
+        if (!first_delivery) {
+            last_delivery = nullptr;
+        }
+        ObjectPool<Delivery>::destroy(delivery);
+    }
+
+    return first_delivery != nullptr;
+}
+
+// Assigns the Message, if there is space for it right now, 
+// and tracks the deadline for it to be taken.
+bool Outbox::try_deliver(
+    Worker* receiver, 
+    const Message& message, 
+    chrono::steady_clock::time_point deadline
+) {
+    DeliveryTicket ticket;
+
+    if (!receiver->assign_message_until(message, chrono::steady_clock::now(), ticket)) {
+        return false;
+    }
+    track_pending_delivery(receiver, ticket, deadline);
+
+    return true;
+}
+
+void Outbox::queue_delivery(Delivery* delivery) {
+    if (last_delivery) {
+        last_delivery->next = delivery;
+    }
+    else {
+        first_delivery = delivery;
+    }
+    last_delivery = delivery;
+}
+
+vector<Worker*> Outbox::take_failed_receivers() {
+    lock_guard<mutex> outbox_lck{outbox_mtx};
+
+    vector<Worker*> receivers{};
+    receivers.swap(failed_receivers);
+
+    // those which weren't redirected since the last call are given up
+    dispose_failed_deliveries(taken_failed_deliveries);
+    taken_failed_deliveries.swap(failed_deliveries);
+
+    return receivers;
+}
+
+void Outbox::deliver() {
+    unique_lock<mutex> outbox_lck{outbox_mtx};
+
+    while (true) {
+        delivery_queued.wait(
+            outbox_lck, 
+            [this](){ return !running || first_delivery; }
+        );
+
+        if (!running) {
+            break;
+        }
+
+        Delivery* delivery{first_delivery};
+        first_delivery = delivery->next;
+        if (!first_delivery) {
+            last_delivery = nullptr;
+        }
+        current_delivery = delivery;
+        outbox_lck.unlock();
+
+        settle_pending_deliveries();
+
+        Worker* receiver{nullptr};
+        chrono::steady_clock::time_point deadline{};
+        DeliveryTicket ticket;
+        bool is_assigned{assign_until_stopped(delivery, receiver, deadline, ticket)};
+
+        if (is_assigned) {
+            track_pending_delivery(receiver, ticket, deadline);
+        }
+
+        outbox_lck.lock();
+        current_delivery = nullptr;
+        if (!is_assigned) {
+            // there was no space for the Message until the deadline,
+            // unless the Outbox has been stopped meanwhile
+            if (running) {
+                add_failed_delivery(receiver, delivery->message);
+            }
+            else {
+                delivery->message.dispose();
+            }
+        }
+        ObjectPool<Delivery>::destroy(delivery);
+    }
+}
+
+// Waits for space for the Message in slices, so stop doesn't wait
+// for a receiver which doesn't take anything until the deadline
+// and a redirected Delivery goes to its new receiver right away.
+// Returns if the Message could be assigned; 
+// the receiver and the deadline are set to those it was last tried with.
+bool Outbox::assign_until_stopped(
+    Delivery* delivery, 
+    Worker*& receiver, 
+    chrono::steady_clock::time_point& deadline, 
+    DeliveryTicket& ticket
+) {
+    while (true) {
+        {
+            lock_guard<mutex> outbox_lck{outbox_mtx};
+            if (!running) {
+                return false;
+            }
+            if (delivery->receiver != receiver) {
+                receiver = delivery->receiver;
+                deadline = 
+                    chrono::steady_clock::now() 
+                        + 
+                    chrono::milliseconds(receiver->get_delivery_waittime());
+            }
+        }
+
+        auto slice_end{min(deadline, chrono::steady_clock::now() + stop_check_interval)};
+
+        if (receiver->assign_message_until(delivery->message, slice_end, ticket)) {
+            return true;
+        }
+        if (slice_end == deadline) {
+            return false;
+        }
+    }
+}
+
+// An assigned Message stays in the mailbox of the receiver, 
+// which may take it yet, if it's only slow, so it's never sent again.
+void Outbox::redirect(Worker* receiver, Worker* new_receiver) {
+    {
+        lock_guard<mutex> pending_lck{pending_mtx};
+
+        PendingDelivery** link{&first_pending_delivery};
+        last_pending_delivery = nullptr;
+        while (*link) {
+            PendingDelivery* pending_delivery{*link};
+            if (pending_delivery->receiver != receiver) {
+                last_pending_delivery = pending_delivery;
+                link = &pending_delivery->next;
+                continue;
+            }
+            *link = pending_delivery->next;
+
+            // its callback has finished when cancel returns
+            TimingWheel::get_instance().cancel(pending_delivery->timer);
+            ObjectPool<PendingDelivery>::destroy(pending_delivery);
+        }
+    }
+
+    lock_guard<mutex> outbox_lck{outbox_mtx};
+
+    // the failed Messages, which were never assigned, were sent before the queued ones
+    vector<Message> messages{};
+    for (auto* deliveries : {&taken_failed_deliveries, &failed_deliveries}) {
+        auto end{remove_if(
+            deliveries->begin(), 
+            deliveries->end(), 
+            [&](const Delivery& delivery){
+                if (delivery.receiver != receiver) {
+                    return false;
+                }
+                messages.push_back(delivery.message);
+                return true;
+            }
+        )};
+        deliveries->erase(end, deliveries->end());
+    }
+
+    auto deadline{
+        chrono::steady_clock::now() 
+            + 
+        chrono::milliseconds(new_receiver->get_delivery_waittime())
+    };
+
+    for (Delivery* delivery{first_delivery}; delivery; delivery = delivery->next) {
+        if (delivery->receiver == receiver) {
+            delivery->receiver = new_receiver;
+            delivery->deadline = deadline;
+        }
+    }
+    if (current_delivery && current_delivery->receiver == receiver) {
+        current_delivery->receiver = new_receiver;
+    }
+
+    for (auto message{messages.rbegin()}; message != messages.rend(); message++) {
+        first_delivery = ObjectPool<Delivery>::create(
+            Delivery{new_receiver, *message, deadline, first_delivery}
+        );
+        if (!last_delivery) {
+            last_delivery = first_delivery;
+        }
+    }
+    if (!messages.empty()) {
+        delivery_queued.notify_one();
+    }
+}
+
+// Tracks the deadline of an assigned Message on the Timing Wheel.
+// The Timer only holds a pointer to the pending Delivery,
+// so its callback fits into the std::function without an allocation.
+void Outbox::track_pending_delivery(
+    Worker* receiver, 
+    DeliveryTicket ticket, 
+    chrono::steady_clock::time_point deadline
+) {
+    PendingDelivery* pending_delivery{
+        ObjectPool<PendingDelivery>::create(
+            PendingDelivery{receiver, ticket, deadline, {}, nullptr}
+        )
+    };
+    lock_guard<mutex> pending_lck{pending_mtx};
+
+    pending_delivery->timer = TimingWheel::get_instance().schedule(
+        deadline, 
+        [this, pending_delivery](){
+            if (!pending_delivery->receiver->has_taken(pending_delivery->ticket)) {
+                report_failed_receiver(pending_delivery->receiver);
+            }
+        }
+    );
+
+    if (last_pending_delivery) {
+        last_pending_delivery->next = pending_delivery;
+    }
+    else {
+        first_pending_delivery = pending_delivery;
+    }
+    last_pending_delivery = pending_delivery;
+}
+
+// Stops tracking the oldest pending deliveries 
+// as soon as they have been taken or their deadline has passed.
+void Outbox::settle_pending_deliveries() {
+    auto now{chrono::steady_clock::now()};
+    lock_guard<mutex> pending_lck{pending_mtx};
+
+    while (first_pending_delivery) {
+        PendingDelivery* pending_delivery{first_pending_delivery};
+        bool is_taken{
+            pending_delivery->receiver->has_taken(pending_delivery->ticket)
+        };
+
+        if (!is_taken && pending_delivery->deadline >= now) {
+            break;
+        }
+
+        // A Timer which has already expired has reported the failure itself.
+        // Its callback has finished when cancel returns, 
+        //   so the pending Delivery can be destroyed afterwards.
+        if (TimingWheel::get_instance().cancel(pending_delivery->timer) 
+                && 
+            !is_taken
+        ) {
+            report_failed_receiver(pending_delivery->receiver);
+        }
+
+        first_pending_delivery = pending_delivery->next;
+        if (!first_pending_delivery) {
+            last_pending_delivery = nullptr;
+        }
+        ObjectPool<PendingDelivery>::destroy(pending_delivery);
+    }
+}
+
+void Outbox::report_failed_delivery(Worker* receiver, const Message& message) {
+    lock_guard<mutex> outbox_lck{outbox_mtx};
+
+    add_failed_delivery(receiver, message);
+}
+
+// Keeps the Message of a failed Delivery, which was never assigned, 
+// besides its receiver, only under the lock.
+void Outbox::add_failed_delivery(Worker* receiver, const Message& message) {
+    failed_receivers.push_back(receiver);
+    failed_deliveries.push_back(Delivery{receiver, message, {}, nullptr});
+}
+
+// An assigned Message, which wasn't taken in time, is left to the receiver.
+void Outbox::report_failed_receiver(Worker* receiver) {
+    lock_guard<mutex> outbox_lck{outbox_mtx};
+
+    failed_receivers.push_back(receiver);
+}
+
+void Outbox::dispose_failed_deliveries(vector<Delivery>& deliveries) {
+    for (Delivery& delivery : deliveries) {
+        delivery.message.dispose();
+    }
+    deliveries.clear();
+}
+
+PoolStatistics Outbox::get_delivery_pool_statistics() {
+    return ObjectPool<Delivery>::get_statistics();
+}
+
+PoolStatistics Outbox::get_pending_delivery_pool_statistics() {
+    return ObjectPool<PendingDelivery>::get_statistics();
+}
+
+Outbox::~Outbox() {
+    stop();
+}
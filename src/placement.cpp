@@ -0,0 +1,114 @@
+#include "placement.h"
+
+#include <algorithm>
+#include <fstream>
+#include <tuple>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std;
+
+
+string to_string(Placement placement) {
+    switch (placement) {
+        case Placement::compact:
+            return "compact";
+        case Placement::scatter:
+            return "scatter";
+        default:
+            return "none";
+    }
+}
+
+bool placement_from_string(const string& name, Placement& placement) {
+    for (Placement candidate : {Placement::none, Placement::compact, Placement::scatter}) {
+        if (name == to_string(candidate)) {
+            placement = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#ifdef __linux__
+// Reads a number describing the CPU's topology from sysfs, -1 if there is none
+static int read_topology_id(int cpu, const string& name) {
+    ifstream file{
+        "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/" + name
+    };
+    int id{-1};
+    file >> id;
+
+    return file ? id : -1;
+}
+#endif
+
+vector<int> get_ordered_cpus() {
+    vector<int> cpus{};
+
+ #ifdef __linux__
+    cpu_set_t allowed_cpus;
+    CPU_ZERO(&allowed_cpus);
+    if (sched_getaffinity(0, sizeof(allowed_cpus), &allowed_cpus) != 0) {
+        return cpus;
+    }
+
+    // package, die, core and the CPU itself, per CPU
+    vector<tuple<int, int, int, int>> topology{};
+    for (int cpu{0}; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed_cpus)) {
+            topology.push_back({
+                read_topology_id(cpu, "physical_package_id"),
+                read_topology_id(cpu, "die_id"),
+                read_topology_id(cpu, "core_id"),
+                cpu
+            });
+        }
+    }
+    sort(topology.begin(), topology.end());
+
+    for (auto& cpu_topology : topology) {
+        cpus.push_back(get<3>(cpu_topology));
+    }
+ #endif
+
+    return cpus;
+}
+
+int get_cpu_for_position(
+    Placement placement,
+    size_t position,
+    size_t number_of_positions,
+    const vector<int>& cpus
+) {
+    if (cpus.empty() || number_of_positions == 0) {
+        return -1;
+    }
+
+    switch (placement) {
+        case Placement::compact:
+            return cpus[position * cpus.size() / number_of_positions];
+        case Placement::scatter:
+            return cpus[position % cpus.size()];
+        default:
+            return -1;
+    }
+}
+
+bool pin_current_thread([[maybe_unused]] int cpu) {
+ #ifdef __linux__
+    if (cpu >= 0) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(cpu, &cpu_set);
+
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+    }
+ #endif
+
+    return false;
+}
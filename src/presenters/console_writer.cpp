@@ -24,7 +24,7 @@ void ConsoleWriter::ring_stopped() {
     print(fg(color::red), "The Ring has stopped.\n");
 }
 
-void ConsoleWriter::worker_says(unsigned int worker_id, const string& message) {
+void ConsoleWriter::worker_says(unsigned int worker_id, std::string_view message) {
     if (logs_to_file()) {
         Logger::worker_says(worker_id, message);
     }
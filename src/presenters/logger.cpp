@@ -12,93 +12,254 @@ Logger::~Logger() {
 }
 
 void Logger::log(spdlog::level::level_enum log_level, const string& message) {
-    logger->log(log_level, message);
+    if (logs(log_level)) {
+        logger->log(log_level, message);
+    }
 }
 
 void Logger::ring_created(size_t ring_size) {
-    logger->debug("The Ring with a size of {} has been created.", ring_size);
+    if (logs(spdlog::level::debug)) {
+        logger->debug("The Ring with a size of {} has been created.", ring_size);
+    }
 }
 
 void Logger::ring_starts() {
-    logger->info("The Ring starts.");
+    if (logs(spdlog::level::info)) {
+        logger->info("The Ring starts.");
+    }
 }
 
 void Logger::ring_started() {
-    logger->info("The Ring started.");
+    if (logs(spdlog::level::info)) {
+        logger->info("The Ring started.");
+    }
+}
+
+void Logger::ring_startup_timed(double id_time, double construction_time, double wiring_time, double start_time) {
+    if (logs(spdlog::level::info)) {
+        logger->info(
+            "The Ring took {:.3f} ms to start up: {:.3f} ms for the ids, {:.3f} ms to construct and {:.3f} ms to wire the Workers and {:.3f} ms to start them.",
+            id_time + construction_time + wiring_time + start_time,
+            id_time,
+            construction_time,
+            wiring_time,
+            start_time
+        );
+    }
 }
 
 void Logger::ring_stops() {
-    logger->info("The Ring stops.");
+    if (logs(spdlog::level::info)) {
+        logger->info("The Ring stops.");
+    }
 }
 
 void Logger::ring_stopped() {
-    logger->info("The Ring stopped.");
+    if (logs(spdlog::level::info)) {
+        logger->info("The Ring stopped.");
+    }
 }
 
 void Logger::worker_created(unsigned int worker_id, unsigned int position) {
-    logger->debug("The Worker with the id {} has been created on position {}.", worker_id, position);
+    if (logs(spdlog::level::debug)) {
+        logger->debug("The Worker with the id {} has been created on position {}.", worker_id, position);
+    }
 }
 
 void Logger::worker_started(unsigned int position) {
-    logger->debug("The Worker on position {} has been started.", position);
+    if (logs(spdlog::level::debug)) {
+        logger->debug("The Worker on position {} has been started.", position);
+    }
+}
+
+void Logger::workers_placed(const string& placement, size_t number_of_cpus) {
+    if (logs(spdlog::level::info)) {
+        if (placement == "none") {
+            logger->info("The Workers' threads are placed by the operating system.");
+        }
+        else {
+            logger->info("The Workers' threads are placed with the {} placement on {} CPUs.", placement, number_of_cpus);
+        }
+    }
 }
 
 void Logger::worker_stopped(unsigned int position) {
-    logger->debug("The Worker with on position {} has been stopped.", position);
+    if (logs(spdlog::level::debug)) {
+        logger->debug("The Worker with on position {} has been stopped.", position);
+    }
 }
 
-void Logger::worker_got_message(unsigned int worker_id, Message* message) {
-    logger->debug("Worker {} got following message: {}", worker_id, (string)*message);
+void Logger::worker_missed_stop_deadline(unsigned int position) {
+    if (logs(spdlog::level::warn)) {
+        logger->warn("The Worker on position {} is still running after the stop deadline.", position);
+    }
 }
 
-void Logger::worker_says(unsigned int worker_id, const string& message) {
-    logger->info("Worker {} says: \"{}\"", worker_id, message);
+void Logger::workers_handled_batches(size_t number_of_batches, size_t number_of_messages, size_t largest_batch) {
+    if (logs(spdlog::level::info)) {
+        logger->info(
+            "The Workers handled {} messages in {} batches, {:.2f} on average and {} at most.", 
+            number_of_messages, 
+            number_of_batches,
+            number_of_batches > 0 ? (double)number_of_messages / number_of_batches : 0.0,
+            largest_batch
+        );
+    }
+}
+
+void Logger::object_pool_used(const string& pool_name, const PoolStatistics& statistics) {
+    if (logs(spdlog::level::info)) {
+        logger->info(
+            "The pool of {} holds {} objects, it held {} at most, {} were freed by another thread and room for {} was reserved.",
+            pool_name,
+            statistics.live_objects,
+            statistics.high_water_mark,
+            statistics.cross_thread_frees,
+            statistics.reserved_objects
+        );
+    }
+}
+
+void Logger::worker_got_message(unsigned int worker_id, const Message& message) {
+    if (logs(spdlog::level::debug)) {
+        logger->debug("Worker {} got following message: {}", worker_id, (string)message);
+    }
+}
+
+void Logger::worker_says(unsigned int worker_id, string_view message) {
+    if (logs(spdlog::level::info)) {
+        logger->info("Worker {} says: \"{}\"", worker_id, message);
+    }
 }
 
 void Logger::worker_starts_election(unsigned int worker_id) {
-    logger->info("Worker {} starts an election.", worker_id);
+    if (logs(spdlog::level::info)) {
+        logger->info("Worker {} starts an election.", worker_id);
+    }
 }
 
 void Logger::worker_participates_in_election(unsigned int worker_id) {
-    logger->debug("Worker {} participates in election.", worker_id);
+    if (logs(spdlog::level::debug)) {
+        logger->debug("Worker {} participates in election.", worker_id);
+    }
 }
 
 void Logger::worker_proposes_itself_in_election(unsigned int worker_id) {
-    logger->info("Worker {} proposes itself as leader.", worker_id);
+    if (logs(spdlog::level::info)) {
+        logger->info("Worker {} proposes itself as leader.", worker_id);
+    }
 }
 
 void Logger::worker_forwards_election_proposal(unsigned int worker_id, unsigned int proposal_id) {
-    logger->info("Worker {} forwards the election proposal for Worker {}.", worker_id, proposal_id);
+    if (logs(spdlog::level::info)) {
+        logger->info("Worker {} forwards the election proposal for Worker {}.", worker_id, proposal_id);
+    }
 }
 
 void Logger::worker_discards_election_proposal(unsigned int worker_id, unsigned int proposal_id) {
-    logger->info("Worker {} discards the election proposal for Worker {}.", worker_id, proposal_id);
+    if (logs(spdlog::level::info)) {
+        logger->info("Worker {} discards the election proposal for Worker {}.", worker_id, proposal_id);
+    }
 }
 
 void Logger::worker_stops_election_participation(unsigned int worker_id) {
-    logger->debug("Worker {} no longer participates in election.", worker_id);
+    if (logs(spdlog::level::debug)) {
+        logger->debug("Worker {} no longer participates in election.", worker_id);
+    }
 }
 
 void Logger::worker_is_elected(unsigned int worker_id) {
-    logger->info("Worker {} has been elected.", worker_id);
+    if (logs(spdlog::level::info)) {
+        logger->info("Worker {} has been elected.", worker_id);
+    }
 }
 
 void Logger::worker_resigns_as_leader(unsigned int worker_id) {
-    logger->debug("Worker {} is no longer the leader.", worker_id);
+    if (logs(spdlog::level::debug)) {
+        logger->debug("Worker {} is no longer the leader.", worker_id);
+    }
+}
+
+void Logger::worker_drops_stale_message(unsigned int worker_id, const Message& message) {
+    if (logs(spdlog::level::debug)) {
+        logger->debug(
+            "Worker {} drops the message of the older election {}: {}", 
+            worker_id, message.epoch, (string)message
+        );
+    }
 }
 
 void Logger::election_is_finished(unsigned int leader_id) {
-    logger->info("The election is finished. Worker {} is the leader.", leader_id);
+    if (logs(spdlog::level::info)) {
+        logger->info("The election is finished. Worker {} is the leader.", leader_id);
+    }
+}
+
+void Logger::election_messages_counted(const string& election_algorithm, size_t number_of_messages) {
+    if (logs(spdlog::level::info)) {
+        logger->info(
+            "The election with {} took {} messages.",
+            election_algorithm,
+            number_of_messages
+        );
+    }
+}
+
+void Logger::election_simulated(unsigned int leader_id, size_t number_of_proposals, size_t number_of_elected_messages, double virtual_latency) {
+    if (logs(spdlog::level::info)) {
+        logger->info(
+            "The simulated election elected Worker {} with {} proposals and {} elected messages after {:.3f} ms of virtual time.",
+            leader_id,
+            number_of_proposals,
+            number_of_elected_messages,
+            virtual_latency
+        );
+    }
+}
+
+void Logger::hierarchy_level_elected(unsigned int level, size_t number_of_rings, double latency) {
+    if (logs(spdlog::level::info)) {
+        logger->info(
+            "Level {} of the hierarchy elected the leaders of its {} rings in {:.3f} ms.",
+            level,
+            number_of_rings,
+            latency
+        );
+    }
+}
+
+void Logger::elections_completed(
+    size_t number_of_elections, 
+    size_t number_of_completed_elections, 
+    size_t number_of_messages, 
+    double elapsed_time
+) {
+    if (logs(spdlog::level::info)) {
+        logger->info(
+            "{} of {} elections completed with {} messages in {:.3f} ms, {:.1f} elections per second.",
+            number_of_completed_elections,
+            number_of_elections,
+            number_of_messages,
+            elapsed_time,
+            elapsed_time > 0 ? number_of_completed_elections * 1000 / elapsed_time : 0
+        );
+    }
 }
 
 void Logger::worker_recognizes_dead_neighbour(unsigned int worker_id, unsigned int neighbour_position) {
-    logger->info("Worker {} recognizes his neighbour on position {} isn't responding.", worker_id, neighbour_position);
+    if (logs(spdlog::level::info)) {
+        logger->info("Worker {} recognizes his neighbour on position {} isn't responding.", worker_id, neighbour_position);
+    }
 }
 
 void Logger::worker_removes_neighbour(unsigned int worker_id, unsigned int neighbour_position) {
-    logger->debug("Worker {} removes neighbour on position {}.", worker_id, neighbour_position);
+    if (logs(spdlog::level::debug)) {
+        logger->debug("Worker {} removes neighbour on position {}.", worker_id, neighbour_position);
+    }
 }
 
 void Logger::worker_adds_neighbour(unsigned int worker_id, unsigned int neighbour_position) {
-    logger->debug("Worker {} adds a new neighbour on position {}.", worker_id, neighbour_position);
+    if (logs(spdlog::level::debug)) {
+        logger->debug("Worker {} adds a new neighbour on position {}.", worker_id, neighbour_position);
+    }
 }
@@ -1,119 +1,643 @@
 #include "ring.h"
+#include "parallel.h"
+#include "unique_ids.h"
 #include "presenters/no_presenter.h"
 
-#include <set>
+#include <algorithm>
+#include <chrono>
+#include <new>
 #include <random>
 
 using namespace std;
 
-vector<unsigned int> get_unique_ids(size_t number_of_ids);
+static double milliseconds_since(chrono::steady_clock::time_point start);
 
 
 Ring::Ring(
     size_t number_of_workers, 
     unsigned int worker_sleeptime, 
-    Presenter* presenter
-) {
+    Presenter* presenter,
+    WorkerOptions worker_options,
+    ExecutionOptions execution_options,
+    SetupOptions setup_options
+): execution_options{execution_options}, 
+   setup_options{setup_options}, 
+   election_algorithm{worker_options.election_algorithm} {
     if (!presenter) {
         presenter = new NoPresenter();
+        owns_presenter = true;
     }
     this->presenter = presenter;
 
-    create_workers(number_of_workers, worker_sleeptime);
+    create_workers(number_of_workers, worker_sleeptime, worker_options);
     set_worker_neighbours();
 
     presenter->ring_created(number_of_workers);
 }
 
+// The Workers are constructed in parallel into one block of memory,
+// which spares the allocator one call per Worker.
 void Ring::create_workers(
     size_t number_of_workers, 
-    unsigned int worker_sleeptime
+    unsigned int worker_sleeptime,
+    WorkerOptions worker_options
 ) {
-    workers.reserve(number_of_workers);
-    auto ids{get_unique_ids(number_of_workers)};
-    
-    for (unsigned int i{0}; i < number_of_workers; i++) {
-        workers.push_back(
-            new Worker(ids[i], i, worker_sleeptime, presenter)
+    auto start{chrono::steady_clock::now()};
+
+    uint64_t seed{setup_options.seed};
+    if (seed == 0) {
+        random_device rd{};
+        seed = ((uint64_t)rd() << 32) | rd();
+    }
+    size_t ring_size{max(setup_options.ring_size, setup_options.first_position + number_of_workers)};
+    auto ids{get_unique_ids(
+        ring_size, 
+        seed, 
+        setup_options.id_layout, 
+        setup_options.number_of_initiators
+    )};
+    ids.erase(ids.begin(), ids.begin() + setup_options.first_position);
+
+    id_time = milliseconds_since(start);
+    start = chrono::steady_clock::now();
+
+    // the delegates of a hierarchical Ring follow its own Workers
+    set_up_levels(number_of_workers);
+    size_t number_of_all_workers{
+        levels.empty() 
+        ? number_of_workers 
+        : levels.back().first_worker + levels.back().number_of_workers
+    };
+
+    if (number_of_all_workers > 0) {
+        worker_storage = static_cast<Worker*>(
+            ::operator new(number_of_all_workers * sizeof(Worker), align_val_t{alignof(Worker)})
         );
+        workers.resize(number_of_all_workers);
+
+        parallel_for(number_of_all_workers, [&](size_t begin, size_t end) {
+            for (size_t i{begin}; i < end; i++) {
+                // in a hierarchical Ring, the position in the Worker's ring
+                size_t position{i};
+                for (const HierarchyLevel& level : levels) {
+                    if (i < level.first_worker + level.number_of_workers) {
+                        size_t index{i - level.first_worker};
+                        position = index - level.get_first_of_ring(level.get_ring(index));
+                        break;
+                    }
+                }
+
+                // a delegate takes on an id, once it stands in for a leader
+                workers[i] = new (worker_storage + i) Worker(
+                    i < number_of_workers ? ids[i] : 0, 
+                    (unsigned int)position, 
+                    worker_sleeptime, 
+                    presenter, 
+                    worker_options
+                );
+                workers[i]->set_election_message_counter(&election_messages);
+                workers[i]->set_completion_handler([this](unsigned int leader_id, uint16_t epoch) {
+                    complete_election(leader_id, epoch);
+                });
+            }
+        });
+    }
+
+    construction_time = milliseconds_since(start);
+
+    for (unsigned int i{0}; i < number_of_workers; i++) {
         presenter->worker_created(ids[i], i);
     }
 }
 
+// All Workers of a flat Ring share one Membership, 
+// in which each finds its neighbour after its own position.
+// This stays sequential, since every Worker takes a reference to the same
+// Membership and parallel threads would only contend for its counter.
 void Ring::set_worker_neighbours() {
-    for (auto it{workers.begin()}; it < workers.end(); it++) {
-        auto first_neighbour{
-            it + 1 == workers.end()
-            ? workers.begin()
-            : it + 1
-        };
-        vector<Worker*> neighbours{first_neighbour, workers.end()};
-        neighbours.insert(neighbours.end(), workers.begin(), it + 1);
+    auto start{chrono::steady_clock::now()};
 
-        (*it)->set_neighbours(move(neighbours));
+    if (!levels.empty()) {
+        set_hierarchy_neighbours();
     }
+    else if (!workers.empty()) {
+        membership = make_shared<SharedMembership>(workers);
+        for (Worker* worker : workers) {
+            worker->set_membership(membership);
+        }
+    }
+
+    wiring_time = milliseconds_since(start);
 }
 
-vector<unsigned int> get_unique_ids(size_t number_of_ids) {
-    unsigned int max_id{
-        number_of_ids < 100 
-            ? 999 
-            : (unsigned int)number_of_ids * 10
-    };
-    set<unsigned int> ids{};
-    random_device rd{};
-    mt19937 gen{rd()};
-    uniform_int_distribution<unsigned int> dis{0, max_id};
+// Each level of a hierarchical Ring has one delegate per ring of the level below,
+// until there is a single ring.
+void Ring::set_up_levels(size_t number_of_workers) {
+    size_t sub_ring_size{setup_options.sub_ring_size};
+    if (sub_ring_size < 2 || sub_ring_size >= number_of_workers) {
+        return;
+    }
 
-    unsigned int i{0};
-    while (i < number_of_ids) {
-        bool was_inserted{ids.insert(dis(gen)).second};
+    size_t first_worker{0};
+    while (true) {
+        size_t number_of_rings{(number_of_workers + sub_ring_size - 1) / sub_ring_size};
+        levels.push_back(HierarchyLevel{first_worker, number_of_workers, number_of_rings});
+        levels.back().leaders.resize(number_of_rings);
+        levels.back().leader_ids.resize(number_of_rings);
 
-        if (was_inserted) {
-            i++;
+        if (number_of_rings == 1) {
+            break;
         }
+        first_worker += number_of_workers;
+        number_of_workers = number_of_rings;
     }
+}
 
-    return vector<unsigned int>{ids.begin(), ids.end()};
+// Every ring of every level has a Membership of its own
+// and its Workers hand over to the Ring once they are elected.
+void Ring::set_hierarchy_neighbours() {
+    for (size_t l{0}; l < levels.size(); l++) {
+        const HierarchyLevel& level{levels[l]};
+
+        for (size_t ring{0}; ring < level.number_of_rings; ring++) {
+            auto first{workers.begin() + level.first_worker};
+            vector<Worker*> ring_workers(
+                first + level.get_first_of_ring(ring), 
+                first + level.get_first_of_ring(ring + 1)
+            );
+
+            auto ring_membership{make_shared<SharedMembership>(ring_workers)};
+            for (Worker* worker : ring_workers) {
+                worker->set_membership(ring_membership);
+                worker->set_election_handler(
+                    [this, l, ring, worker](unsigned int leader_id, uint16_t epoch) {
+                        ring_elected(l, ring, worker, leader_id, epoch);
+                    }
+                );
+            }
+        }
+    }
+}
+
+size_t HierarchyLevel::get_ring(size_t index) const {
+    return index * number_of_rings / number_of_workers;
+}
+
+size_t HierarchyLevel::get_first_of_ring(size_t ring) const {
+    return (ring * number_of_workers + number_of_rings - 1) / number_of_rings;
+}
+
+static double milliseconds_since(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+void Ring::connect(unique_ptr<Transport> transport) {
+    this->transport = move(transport);
+    if (!workers.empty()) {
+        this->transport->set_delivery_waittime(workers.front()->get_delivery_waittime());
+    }
+
+    // the rings of a hierarchical Ring stay among themselves
+    if (membership) {
+        for (Worker* worker : workers) {
+            worker->set_transport(this->transport.get());
+        }
+    }
 }
 
 void Ring::start() {
     presenter->ring_starts();
-
-    worker_threads.clear();
-    worker_threads.reserve(workers.size());
+    auto start{chrono::steady_clock::now()};
 
     running = true;
 
-    for (unsigned int i{0}; i < workers.size(); i++) {
-        worker_threads.push_back(thread{ref(*workers[i])});
-        presenter->worker_started(i);
+    Placement placement{Placement::none};
+    vector<int> cpus{};
+
+    if (execution_options.use_tasks) {
+        scheduler = make_unique<Scheduler>(execution_options.number_of_threads);
+
+        for (unsigned int i{0}; i < workers.size(); i++) {
+            workers[i]->start_as_task(scheduler.get());
+            presenter->worker_started(i);
+        }
+    }
+    else if (execution_options.use_shards) {
+        cpus = get_ordered_cpus();
+        placement = cpus.empty() ? Placement::none : Placement::compact;
+        start_shards(cpus);
+    }
+    else {
+        if (execution_options.placement != Placement::none) {
+            cpus = get_ordered_cpus();
+            placement = cpus.empty() ? Placement::none : execution_options.placement;
+        }
+        start_threads(placement == Placement::none ? vector<int>{} : cpus);
+    }
+
+    presenter->workers_placed(to_string(placement), cpus.size());
+
+    // once the Workers take Messages where they run
+    if (transport && membership) {
+        start_transport();
     }
+    election_outbox.start();
 
+    presenter->ring_startup_timed(
+        id_time, 
+        construction_time, 
+        wiring_time, 
+        milliseconds_since(start)
+    );
     presenter->ring_started();
 }
 
-void Ring::start_election() {
-    if (worker_threads.size() > 0) {
-        workers[0]->assign_message(new StartElection());
+// Starts each Worker in its own thread, the threads are started in parallel.
+// The stack size only applies to the Workers' threads and their Outboxes' sender threads.
+// The Workers pin their threads to the CPUs according to the placement,
+// unless there are none.
+void Ring::start_threads(const vector<int>& cpus) {
+    size_t stack_size{setup_options.stack_size};
+    if (!SizedThread::can_use_stack_size(stack_size)) {
+        presenter->log(
+            spdlog::level::warn, 
+            "The stack size of the Workers' threads couldn't be set."
+        );
+        stack_size = 0;
+    }
+
+    worker_threads.clear();
+    worker_threads.resize(workers.size());
+
+    parallel_for(workers.size(), [this, &cpus, stack_size](size_t begin, size_t end) {
+        for (size_t i{begin}; i < end; i++) {
+            workers[i]->set_cpu(get_cpu_for_position(
+                execution_options.placement, i, workers.size(), cpus
+            ));
+            workers[i]->set_sender_stack_size(stack_size);
+            worker_threads[i] = SizedThread{stack_size, ref(*workers[i])};
+        }
+    });
+
+    for (unsigned int i{0}; i < workers.size(); i++) {
+        presenter->worker_started(i);
     }
 }
 
-void Ring::stop() {
-    presenter->ring_stops();
+// Splits the Ring into contiguous segments of about equal size, one per Shard,
+// so a Message only crosses to another Shard at the end of a segment.
+// Neighbouring Shards are pinned to CPUs next to each other in the topology.
+void Ring::start_shards(const vector<int>& cpus) {
+    size_t number_of_shards{
+        execution_options.number_of_threads > 0
+        ? execution_options.number_of_threads
+        : max(1u, thread::hardware_concurrency())
+    };
+    number_of_shards = min(number_of_shards, workers.size());
+
+    for (size_t i{0}; i < number_of_shards; i++) {
+        shards.push_back(make_unique<Shard>(i));
+    }
+    for (size_t i{0}; i < number_of_shards; i++) {
+        shards[i]->set_next_shard(shards[(i + 1) % number_of_shards].get());
+    }
+    for (size_t i{0}; i < workers.size(); i++) {
+        shards[i * number_of_shards / workers.size()]->add_worker(workers[i]);
+    }
 
+    for (size_t i{0}; i < number_of_shards; i++) {
+        shards[i]->start(cpus.empty() ? -1 : cpus[i % cpus.size()]);
+    }
+    for (unsigned int i{0}; i < workers.size(); i++) {
+        presenter->worker_started(i);
+    }
+}
+
+// Requests all Workers to stop at once, which cuts their sleeps short,
+// and then waits for all of them together instead of one after another.
+// The Workers still running after the deadline are reported,
+// before the threads are joined nevertheless.
+void Ring::stop_threads() {
     for (unsigned int i{0}; i < worker_threads.size(); i++) {
-        if (worker_threads[i].joinable() 
-            && 
-            workers[i]->is_running()
+        if (worker_threads[i].joinable()) {
+            workers[i]->request_stop();
+        }
+    }
+
+    auto deadline{
+        chrono::steady_clock::now() + chrono::milliseconds(execution_options.stop_deadline)
+    };
+    // the Workers before it have all stopped
+    size_t first_running{0};
+    while (true) {
+        while (first_running < worker_threads.size()
+                &&
+            (!worker_threads[first_running].joinable() || !workers[first_running]->is_running())
         ) {
-            workers[i]->assign_message(new Stop());
+            first_running++;
+        }
+
+        if (first_running == worker_threads.size() || chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+
+    for (size_t i{first_running}; i < worker_threads.size(); i++) {
+        if (worker_threads[i].joinable() && workers[i]->is_running()) {
+            presenter->worker_missed_stop_deadline(i);
+        }
+    }
+
+    for (unsigned int i{0}; i < worker_threads.size(); i++) {
+        if (worker_threads[i].joinable()) {
             worker_threads[i].join();
             presenter->worker_stopped(i);
         }
     }
 
     worker_threads.clear();
+}
+
+// What arrives from the previous segment is queued for the first Worker,
+// whichever it is at the time, and assigned to it by the Outbox's sender thread,
+// so a busy first Worker doesn't hold up the Transport.
+void Ring::start_transport() {
+    transport_outbox.start();
+
+    transport->start([this](const Message& message) {
+        handle_failed_transport_deliveries();
+
+        transport_outbox.send(membership->get()->at(0), message);
+    });
+}
+
+// A first Worker, which didn't take a Message from the previous segment in time,
+// is removed like any dead neighbour, as the previous segment can't remove it.
+void Ring::handle_failed_transport_deliveries() {
+    for (Worker* receiver : transport_outbox.take_failed_receivers()) {
+        auto current_membership{membership->get()};
+
+        // Otherwise it has already been removed because of an earlier failed delivery.
+        if (current_membership->size() > 1 && current_membership->at(0) == receiver) {
+            presenter->log(
+                spdlog::level::warn,
+                "The first worker didn't take a message from the previous segment in time, "
+                    "so it's removed."
+            );
+            membership->remove(receiver);
+
+            transport_outbox.redirect(receiver, membership->get()->at(0));
+            transport_outbox.send(membership->get()->at(0), Message::dead_worker(0));
+        }
+    }
+}
+
+future<ElectionResult> Ring::start_election() {
+    if (!running || setup_options.first_position > 0) {
+        return {};
+    }
+
+    future<ElectionResult> election{};
+    {
+        lock_guard<mutex> election_lck{election_mtx};
+        epoch++;
+        // the outcome of a superseded election is broken
+        election_promise = promise<ElectionResult>{};
+        election = election_promise.get_future();
+        is_election_pending = true;
+        election_start = chrono::steady_clock::now();
+    }
+
+    // what couldn't be assigned for an election before is given up
+    election_outbox.take_failed_receivers();
+
+    if (!levels.empty()) {
+        lock_guard<mutex> hierarchy_lck{hierarchy_mtx};
+        start_level(0);
+    }
+    else {
+        start_election_among(0, workers.size());
+    }
+
+    return election;
+}
+
+// Chang and Roberts and Peterson are started by the initiators of a ring,
+// Hirschberg and Sinclair by all of its Workers.
+void Ring::start_election_among(size_t first_worker, size_t end_worker) {
+    size_t number_of_initiators{
+        election_algorithm == ElectionAlgorithm::hirschberg_sinclair
+        ? 0
+        : setup_options.number_of_initiators
+    };
+
+    for (size_t position : get_initiator_positions(end_worker - first_worker, number_of_initiators)) {
+        election_outbox.send(workers[first_worker + position], Message::start_election(epoch));
+    }
+}
+
+// Starts the elections in all rings of the level at once.
+// The delegates of a level above are sent the ids of the leaders below first,
+// which they take on in their own thread, since all of them need to know
+// for whom they stand in, before any proposal reaches them;
+// the election Outbox assigns in order, so the StandIns are ahead of it.
+void Ring::start_level(size_t l) {
+    HierarchyLevel& level{levels[l]};
+
+    if (l > 0) {
+        for (size_t i{0}; i < level.number_of_workers; i++) {
+            election_outbox.send(
+                workers[level.first_worker + i], 
+                Message::stand_in(levels[l - 1].leader_ids[i], epoch)
+            );
+        }
+    }
+
+    electing_level = l;
+    fill(level.leaders.begin(), level.leaders.end(), nullptr);
+    rings_left = level.number_of_rings;
+    level_start = chrono::steady_clock::now();
+
+    for (size_t ring{0}; ring < level.number_of_rings; ring++) {
+        start_election_among(
+            level.first_worker + level.get_first_of_ring(ring), 
+            level.first_worker + level.get_first_of_ring(ring + 1)
+        );
+    }
+}
+
+// Called by the leader of a ring, once its ring has elected it.
+// The level above starts, as soon as all rings of the level have elected their leaders.
+// A ring of an election, which a newer one has superseded, is ignored,
+// just as a ring which isn't electing or has elected its leader already,
+// since an initiator, whose start arrives late, can be elected once more.
+void Ring::ring_elected(
+    size_t l, 
+    size_t ring, 
+    Worker* leader, 
+    unsigned int leader_id, 
+    uint16_t epoch
+) {
+    bool is_elected{false};
+    {
+        lock_guard<mutex> hierarchy_lck{hierarchy_mtx};
+        if (epoch != this->epoch || l != electing_level || levels[l].leaders[ring]) {
+            return;
+        }
+        HierarchyLevel& level{levels[l]};
+
+        level.leaders[ring] = leader;
+        level.leader_ids[ring] = leader_id;
+
+        if (--rings_left > 0) {
+            return;
+        }
+
+        presenter->hierarchy_level_elected(
+            (unsigned int)l, 
+            level.number_of_rings, 
+            milliseconds_since(level_start)
+        );
+
+        if (l + 1 < levels.size()) {
+            start_level(l + 1);
+        }
+        else {
+            announce_leader(leader_id, epoch);
+            is_elected = true;
+        }
+    }
+
+    if (is_elected) {
+        complete_election(leader_id, epoch);
+    }
+}
+
+// Announces the leader down the hierarchy to the leaders of all rings below,
+// unless they are the leader or stand in for it,
+// which resign and pass it around their rings, so every Worker learns about it;
+// in the epoch of the election, which elected it.
+void Ring::announce_leader(unsigned int leader_id, uint16_t epoch) {
+    for (size_t l{0}; l + 1 < levels.size(); l++) {
+        for (size_t ring{0}; ring < levels[l].number_of_rings; ring++) {
+            if (levels[l].leader_ids[ring] != leader_id) {
+                Message elected{Message::elected(leader_id)};
+                elected.epoch = epoch;
+                election_outbox.send(levels[l].leaders[ring], elected);
+            }
+        }
+    }
+}
+
+// Reports the election and fulfills its outcome,
+// unless a newer election has superseded it.
+// A segment, which doesn't start the elections, only reports them.
+void Ring::complete_election(unsigned int leader_id, uint16_t epoch) {
+    lock_guard<mutex> election_lck{election_mtx};
+    bool is_started_here{setup_options.first_position == 0};
+    if (is_started_here && (epoch != this->epoch || !is_election_pending)) {
+        return;
+    }
+
+    ElectionResult result{
+        leader_id, 
+        election_messages.take(epoch), 
+        milliseconds_since(election_start),
+        epoch
+    };
+
+    presenter->election_messages_counted(to_string(election_algorithm), result.number_of_messages);
+    presenter->election_is_finished(leader_id);
+
+    if (is_started_here) {
+        is_election_pending = false;
+        election_promise.set_value(result);
+    }
+}
+
+void Ring::stop() {
+    presenter->ring_stops();
+
+    // no election is started or announced anymore
+    election_outbox.stop();
+
+    // nothing is assigned from the previous segment anymore
+    if (transport) {
+        transport->stop();
+        transport_outbox.stop();
+    }
+
+    if (scheduler) {
+        for (Worker* worker : workers) {
+            if (worker->is_running()) {
+                worker->assign_message(Message::stop());
+            }
+        }
+
+        // idle as soon as every Worker has handled its Stop
+        scheduler->wait_until_idle();
+        scheduler.reset();
+
+        for (unsigned int i{0}; i < workers.size(); i++) {
+            presenter->worker_stopped(i);
+        }
+    }
+
+    if (!shards.empty()) {
+        for (Worker* worker : workers) {
+            if (worker->is_running()) {
+                worker->assign_message(Message::stop());
+            }
+        }
+
+        // every Shard finishes as soon as all of its Workers have stopped,
+        // they are only destroyed afterwards, 
+        // since they may still send to each other until then
+        for (auto& shard : shards) {
+            shard->join();
+        }
+        shards.clear();
+
+        for (unsigned int i{0}; i < workers.size(); i++) {
+            presenter->worker_stopped(i);
+        }
+    }
+
+    if (!worker_threads.empty()) {
+        stop_threads();
+    }
+
+    BatchStatistics batch_statistics{};
+    for (Worker* worker : workers) {
+        batch_statistics += worker->get_batch_statistics();
+    }
+    presenter->workers_handled_batches(
+        batch_statistics.number_of_batches,
+        batch_statistics.number_of_messages,
+        batch_statistics.largest_batch
+    );
+    presenter->object_pool_used("deliveries", Outbox::get_delivery_pool_statistics());
+    presenter->object_pool_used(
+        "pending deliveries", 
+        Outbox::get_pending_delivery_pool_statistics()
+    );
+    for (size_t size_class{0}; size_class < BufferPool::number_of_size_classes; size_class++) {
+        presenter->object_pool_used(
+            fmt::format(
+                "log message contents of up to {} characters", 
+                BufferPool::get_capacity(size_class)
+            ), 
+            BufferPool::get_statistics(size_class)
+        );
+    }
+
+    {
+        // the outcome of an election still going on is broken
+        lock_guard<mutex> election_lck{election_mtx};
+        election_promise = promise<ElectionResult>{};
+        is_election_pending = false;
+    }
 
     running = false;
 
@@ -126,41 +650,620 @@ Ring::~Ring() {
     }
     
     for (Worker* worker : workers) {
-        delete worker;
+        worker->~Worker();
+    }
+    if (worker_storage) {
+        ::operator delete(worker_storage, align_val_t{alignof(Worker)});
     }
 
-    // if the presenter is no presenter it needs to be deleted
-    NoPresenter* no_presenter{dynamic_cast<NoPresenter*>(presenter)};
-    if (no_presenter) {
-        delete no_presenter;
+    // if the ring created its own no presenter it needs to be deleted
+    if (owns_presenter) {
+        delete presenter;
     }
 }
 
 
 #ifdef UNIT_TEST
+#include "presenters/logger.h"
+
 #include "catch2/catch.hpp"
+#include <spdlog/sinks/null_sink.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+
+// A Presenter which records the highest id and the leader of the last election
+// and logs nothing else
+class ElectionRecorder: public Logger {
+  public:
+    unsigned int highest_id{0};
+    atomic<unsigned int> leader_id{0};
+    atomic<bool> election_finished{false};
+    vector<size_t> rings_per_level{};
+    size_t number_of_election_messages{0};
+    size_t largest_batch{0};
+    // the Workers which are leaders
+    mutex leaders_mtx;
+    set<unsigned int> leaders{};
+    // the Workers which have learned about the Worker with the highest id as leader
+    mutex informed_mtx;
+    set<unsigned int> informed{};
+
+    ElectionRecorder(): Logger(
+        make_shared<spdlog::logger>("recorder", make_shared<spdlog::sinks::null_sink_mt>()),
+        false
+    ) {}
+
+    void worker_created(unsigned int worker_id, unsigned int) override {
+        highest_id = max(highest_id, worker_id);
+    }
+
+    void election_is_finished(unsigned int leader_id) override {
+        this->leader_id = leader_id;
+        election_finished = true;
+    }
+
+    void worker_got_message(unsigned int worker_id, const Message& message) override {
+        if (message.type == MessageType::Elected && message.id == highest_id) {
+            lock_guard<mutex> informed_lck{informed_mtx};
+            informed.insert(worker_id);
+        }
+    }
+
+    void worker_is_elected(unsigned int worker_id) override {
+        lock_guard<mutex> leaders_lck{leaders_mtx};
+        leaders.insert(worker_id);
+    }
+
+    void worker_resigns_as_leader(unsigned int worker_id) override {
+        lock_guard<mutex> leaders_lck{leaders_mtx};
+        leaders.erase(worker_id);
+    }
+
+    void election_messages_counted(const string&, size_t number_of_messages) override {
+        number_of_election_messages = number_of_messages;
+    }
+
+    void workers_handled_batches(size_t, size_t, size_t largest_batch) override {
+        this->largest_batch = largest_batch;
+    }
+
+    void hierarchy_level_elected(unsigned int, size_t number_of_rings, double) override {
+        rings_per_level.push_back(number_of_rings);
+    }
+};
+
+// Waits up to 5 s for an election to finish and returns if it has.
+static bool wait_for_election(const ElectionRecorder& recorder) {
+    auto deadline{chrono::steady_clock::now() + chrono::seconds(5)};
+    while (!recorder.election_finished && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+
+    return recorder.election_finished;
+}
+
+TEST_CASE(
+    "Ring stops all Workers in their own threads at once and cuts their sleeps short", 
+    "[ring]"
+) {
+    ElectionRecorder recorder{};
+    Ring ring(20, 2000, &recorder);
+    ring.start();
+    this_thread::sleep_for(chrono::milliseconds(50));
+
+    auto start{chrono::steady_clock::now()};
+    ring.stop();
+
+    // one after another, each Worker would first finish its sleep of 2 s
+    CHECK(chrono::steady_clock::now() - start < chrono::seconds(1));
+}
+
+#ifdef __GLIBC__
+TEST_CASE(
+    "Ring gives the stack size only to its Workers' threads and leaves the default of the process",
+    "[ring]"
+) {
+    auto get_default_stack_size{[](){
+        size_t stack_size{0};
+        pthread_attr_t attributes;
+        if (pthread_getattr_default_np(&attributes) == 0) {
+            pthread_attr_getstacksize(&attributes, &stack_size);
+            pthread_attr_destroy(&attributes);
+        }
+        return stack_size;
+    }};
+    size_t default_stack_size{get_default_stack_size()};
+
+    ElectionRecorder recorder{};
+    Ring ring(10, 0, &recorder, WorkerOptions{}, ExecutionOptions{}, SetupOptions{0, 256 * 1024});
+    ring.start();
+
+    // a thread started meanwhile by anyone else keeps the default
+    CHECK(get_default_stack_size() == default_stack_size);
+
+    ring.start_election();
+    CHECK(wait_for_election(recorder));
+    CHECK(recorder.leader_id == recorder.highest_id);
+
+    ring.stop();
+}
+#endif
+
+// A Transport which only keeps the Receiver, through which the tests hand over
+// what arrives from the previous segment
+class ReceiverTransport: public Transport {
+  public:
+    Receiver receiver{};
+
+    void start(Receiver receiver) override {
+        this->receiver = move(receiver);
+    }
+
+    void send(const Message& message) override {
+        Message sent_message{message};
+        sent_message.dispose();
+    }
+
+    void stop() override {}
+};
 
 TEST_CASE(
-    "get_unique_ids returns the request amount of unique and random ids", 
-    "[get_unique_ids]"
+    "Ring hands what arrives from the previous segment on without waiting for the first Worker", 
+    "[ring]"
 ) {
-    size_t size{GENERATE(5, 12, 21, 100)};
-    auto ids{get_unique_ids(size)};
+    ElectionRecorder recorder{};
+    auto transport{make_unique<ReceiverTransport>()};
+    ReceiverTransport* receiving_transport{transport.get()};
+
+    Ring ring(2, 500, &recorder, WorkerOptions{1, 1});
+    ring.connect(move(transport));
+    ring.start();
+
+    // the first Worker sleeps after each Message and has space for only one more
+    auto start{chrono::steady_clock::now()};
+    for (int i{0}; i < 5; i++) {
+        receiving_transport->receiver(Message::log_message("from the previous segment"));
+    }
+
+    CHECK(chrono::steady_clock::now() - start < chrono::milliseconds(250));
 
-    REQUIRE(ids.size() == size);
+    ring.stop();
+}
+
+TEST_CASE(
+    "Ring elects the Worker with the highest id with its Workers as Tasks", 
+    "[ring]"
+) {
+    size_t size{GENERATE(2, 50)};
+    size_t mailbox_capacity{GENERATE(1, 64)};
+    ElectionRecorder recorder{};
 
-    SECTION("there are no duplicate ids and they are randomized") {
-        set<unsigned int> unique_ids{ids.begin(), ids.end()};
+    {
+        Ring ring(
+            size, 
+            0, 
+            &recorder, 
+            WorkerOptions{mailbox_capacity, 64}, 
+            ExecutionOptions{true, false, 2}
+        );
+        ring.start();
+        ring.start_election();
 
-        REQUIRE(unique_ids.size() == size);
+        wait_for_election(recorder);
 
-        SECTION("the ids are not always the same") {
-            vector<unsigned int> other_ids{get_unique_ids(size)};
-            unique_ids.insert(other_ids.begin(), other_ids.end());
+        ring.stop();
 
-            CHECK(unique_ids.size() > size);
+        REQUIRE(recorder.election_finished);
+        CHECK(recorder.leader_id == recorder.highest_id);
+    }
+}
+
+TEST_CASE(
+    "Ring elects the Worker with the highest id with its Workers in Shards", 
+    "[ring]"
+) {
+    size_t size{GENERATE(2, 50)};
+    size_t number_of_shards{GENERATE(1, 3)};
+    ElectionRecorder recorder{};
+
+    {
+        Ring ring(
+            size, 
+            0, 
+            &recorder, 
+            WorkerOptions{}, 
+            ExecutionOptions{false, true, number_of_shards}
+        );
+        ring.start();
+        ring.start_election();
+
+        wait_for_election(recorder);
+
+        ring.stop();
+
+        REQUIRE(recorder.election_finished);
+        CHECK(recorder.leader_id == recorder.highest_id);
+    }
+}
+
+TEST_CASE(
+    "Ring hands the Workers in Shards their due Messages up to their batch limit", 
+    "[ring]"
+) {
+    size_t batch_limit{GENERATE(1, 8)};
+    ElectionRecorder recorder{};
+
+    {
+        // every Worker probes both of its neighbours at once
+        Ring ring(
+            20, 
+            10, 
+            &recorder, 
+            WorkerOptions{1, batch_limit, 0, ElectionAlgorithm::hirschberg_sinclair}, 
+            ExecutionOptions{false, true, 1}
+        );
+        ring.start();
+        ring.start_election();
+
+        wait_for_election(recorder);
+
+        ring.stop();
+
+        REQUIRE(recorder.election_finished);
+        CHECK(recorder.leader_id == recorder.highest_id);
+        CHECK(recorder.largest_batch <= batch_limit);
+    }
+}
+
+// An Election Recorder which stalls the thread of the leader's predecessor once,
+// when it gets the Elected Message, so the leader misses its deadline,
+// and which records the Workers removing a neighbour
+class StallingRecorder: public ElectionRecorder {
+  public:
+    vector<unsigned int> ids{};
+    atomic<bool> has_stalled{false};
+    mutex removals_mtx;
+    set<unsigned int> removing_workers{};
+
+    void worker_created(unsigned int worker_id, unsigned int position) override {
+        ElectionRecorder::worker_created(worker_id, position);
+        ids.resize(max(ids.size(), (size_t)position + 1));
+        ids[position] = worker_id;
+    }
+
+    void worker_got_message(unsigned int worker_id, const Message& message) override {
+        size_t leader_position{
+            (size_t)(find(ids.begin(), ids.end(), highest_id) - ids.begin())
+        };
+        unsigned int predecessor_id{ids[(leader_position + ids.size() - 1) % ids.size()]};
+
+        if (message.type == MessageType::Elected 
+                && worker_id == predecessor_id 
+                && !has_stalled.exchange(true)
+        ) {
+            this_thread::sleep_for(chrono::milliseconds(1200));
         }
     }
+
+    void worker_removes_neighbour(unsigned int worker_id, unsigned int) override {
+        lock_guard<mutex> removals_lck{removals_mtx};
+        removing_workers.insert(worker_id);
+    }
+};
+
+TEST_CASE(
+    "Ring removes a Worker in Shards, which missed its deadline, along the whole Ring", 
+    "[ring]"
+) {
+    StallingRecorder recorder{};
+
+    {
+        // The leader handles the Elected Message last and too late,
+        // so its removal is the only Message left afterwards.
+        Ring ring(
+            3, 
+            0, 
+            &recorder, 
+            WorkerOptions{}, 
+            ExecutionOptions{false, true, 1}
+        );
+        ring.start();
+        ring.start_election();
+
+        REQUIRE(wait_for_election(recorder));
+
+        // the removing predecessor and the Worker after the leader
+        auto deadline{chrono::steady_clock::now() + chrono::seconds(3)};
+        size_t number_of_removing_workers{0};
+        while (number_of_removing_workers < 2 && chrono::steady_clock::now() < deadline) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+            lock_guard<mutex> removals_lck{recorder.removals_mtx};
+            number_of_removing_workers = recorder.removing_workers.size();
+        }
+
+        ring.stop();
+
+        CHECK(number_of_removing_workers == 2);
+    }
+}
+
+TEST_CASE(
+    "Ring elects the Worker with the highest id started by several initiators", 
+    "[ring]"
+) {
+    size_t number_of_initiators{GENERATE(0, 4)};
+    IdLayout id_layout{GENERATE(IdLayout::random, IdLayout::adversarial)};
+    ElectionRecorder recorder{};
+
+    {
+        Ring ring(
+            30, 
+            0, 
+            &recorder, 
+            WorkerOptions{64, 64}, 
+            ExecutionOptions{true, false, 2},
+            SetupOptions{0, 0, 0, 0, 0, id_layout, number_of_initiators}
+        );
+        ring.start();
+        ring.start_election();
+
+        wait_for_election(recorder);
+
+        ring.stop();
+
+        REQUIRE(recorder.election_finished);
+        CHECK(recorder.leader_id == recorder.highest_id);
+    }
+}
+
+TEST_CASE(
+    "Ring lets each election supersede those still going on", 
+    "[ring]"
+) {
+    ElectionAlgorithm election_algorithm{GENERATE(
+        ElectionAlgorithm::chang_roberts,
+        ElectionAlgorithm::hirschberg_sinclair,
+        ElectionAlgorithm::peterson
+    )};
+    ElectionRecorder recorder{};
+
+    {
+        Ring ring(
+            30, 
+            0, 
+            &recorder, 
+            WorkerOptions{64, 64, 0, election_algorithm}, 
+            ExecutionOptions{true, false, 2},
+            SetupOptions{0, 0, 0, 0, 0, IdLayout::random, 0}
+        );
+        ring.start();
+        vector<future<ElectionResult>> elections{};
+        for (int i{0}; i < 10; i++) {
+            elections.push_back(ring.start_election());
+        }
+
+        // the newest election finishes, whichever else may have finished before it
+        REQUIRE(elections.back().wait_for(chrono::seconds(5)) == future_status::ready);
+        ElectionResult result{elections.back().get()};
+
+        for (size_t i{0}; i + 1 < elections.size(); i++) {
+            REQUIRE(elections[i].wait_for(chrono::seconds(0)) == future_status::ready);
+            bool is_broken{false};
+            ElectionResult superseded_result{};
+            try {
+                superseded_result = elections[i].get();
+            }
+            catch (const future_error& error) {
+                is_broken = error.code() == future_errc::broken_promise;
+            }
+            CHECK((is_broken || is_older_epoch(superseded_result.epoch, result.epoch)));
+        }
+
+        ring.stop();
+
+        CHECK(result.leader_id == recorder.highest_id);
+        CHECK(recorder.leaders == set<unsigned int>{recorder.highest_id});
+    }
+}
+
+TEST_CASE(
+    "Ring completes the future of each election with its outcome", 
+    "[ring]"
+) {
+    size_t sub_ring_size{GENERATE(0, 4)};
+    ElectionRecorder recorder{};
+
+    {
+        Ring ring(
+            30, 
+            0, 
+            &recorder, 
+            WorkerOptions{64, 64}, 
+            ExecutionOptions{true, false, 2},
+            SetupOptions{0, 0, 0, 0, sub_ring_size}
+        );
+        ring.start();
+
+        SECTION("one election after another") {
+            for (int i{0}; i < 5; i++) {
+                future<ElectionResult> election{ring.start_election()};
+
+                REQUIRE(election.valid());
+                REQUIRE(election.wait_for(chrono::seconds(5)) == future_status::ready);
+
+                ElectionResult result{election.get()};
+                CHECK(result.leader_id == recorder.highest_id);
+                CHECK(result.epoch == i + 1);
+                // at least the Elected Message passes every Worker
+                CHECK(result.number_of_messages >= 30);
+                CHECK(result.elapsed_time > 0);
+            }
+        }
+
+        SECTION("a newer election breaks the future of the one before") {
+            future<ElectionResult> superseded_election{ring.start_election()};
+            future<ElectionResult> election{ring.start_election()};
+
+            // unless it has completed in the meantime, it's broken right away
+            REQUIRE(superseded_election.wait_for(chrono::seconds(0)) == future_status::ready);
+            bool is_broken{false};
+            ElectionResult superseded_result{};
+            try {
+                superseded_result = superseded_election.get();
+            }
+            catch (const future_error& error) {
+                is_broken = error.code() == future_errc::broken_promise;
+            }
+            CHECK((is_broken || superseded_result.leader_id == recorder.highest_id));
+            REQUIRE(election.wait_for(chrono::seconds(5)) == future_status::ready);
+            CHECK(election.get().leader_id == recorder.highest_id);
+        }
+
+        ring.stop();
+
+        CHECK_FALSE(ring.start_election().valid());
+    }
+}
+
+TEST_CASE(
+    "Ring elects the Worker with the highest id level by level in sub-rings", 
+    "[ring]"
+) {
+    bool use_tasks{GENERATE(false, true)};
+    ElectionRecorder recorder{};
+
+    {
+        // 50 Workers in 13 rings, their leaders in 4 rings and those in 1
+        Ring ring(
+            50, 
+            0, 
+            &recorder, 
+            WorkerOptions{}, 
+            ExecutionOptions{use_tasks, false, 2},
+            SetupOptions{7, 0, 0, 0, 4}
+        );
+        ring.start();
+        ring.start_election();
+
+        wait_for_election(recorder);
+
+        // the leader is announced around the rings below after the election has finished
+        auto deadline{chrono::steady_clock::now() + chrono::seconds(5)};
+        size_t number_of_informed{0};
+        while (number_of_informed < 50 && chrono::steady_clock::now() < deadline) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+            lock_guard<mutex> informed_lck{recorder.informed_mtx};
+            number_of_informed = recorder.informed.size();
+        }
+
+        ring.stop();
+
+        REQUIRE(recorder.election_finished);
+        CHECK(recorder.leader_id == recorder.highest_id);
+        CHECK(recorder.rings_per_level == vector<size_t>{13, 4, 1});
+        // every Worker, delegates reporting the ids they stand in for
+        CHECK(recorder.informed.size() == 50);
+    }
+}
+
+TEST_CASE(
+    "Ring lets each election supersede those still going on level by level in sub-rings", 
+    "[ring]"
+) {
+    ElectionRecorder recorder{};
+
+    {
+        // the single-slot mailboxes are full while the leaders below elect the rings above
+        Ring ring(
+            50, 
+            0, 
+            &recorder, 
+            WorkerOptions{}, 
+            ExecutionOptions{false, false, 0},
+            SetupOptions{7, 0, 0, 0, 4, IdLayout::random, 0}
+        );
+        ring.start();
+        vector<future<ElectionResult>> elections{};
+        for (int i{0}; i < 10; i++) {
+            elections.push_back(ring.start_election());
+        }
+
+        REQUIRE(elections.back().wait_for(chrono::seconds(5)) == future_status::ready);
+        CHECK(elections.back().get().leader_id == recorder.highest_id);
+
+        ring.stop();
+    }
+}
+
+TEST_CASE(
+    "Ring elects level by level in sub-rings with single-slot mailboxes on a single Task thread",
+    "[ring]"
+) {
+    ElectionRecorder recorder{};
+
+    {
+        // The leaders are elected on the Scheduler's only thread,
+        // which the Workers with the full mailboxes of the rings above need as well.
+        Ring ring(
+            50,
+            0,
+            &recorder,
+            WorkerOptions{},
+            ExecutionOptions{true, false, 1},
+            SetupOptions{7, 0, 0, 0, 4, IdLayout::random, 0}
+        );
+        ring.start();
+        vector<future<ElectionResult>> elections{};
+        for (int i{0}; i < 10; i++) {
+            elections.push_back(ring.start_election());
+        }
+
+        REQUIRE(elections.back().wait_for(chrono::seconds(5)) == future_status::ready);
+        CHECK(elections.back().get().leader_id == recorder.highest_id);
+
+        ring.stop();
+    }
+}
+
+TEST_CASE(
+    "Ring elects the Worker with the highest id with Hirschberg and Sinclair or Peterson", 
+    "[ring]"
+) {
+    ElectionAlgorithm election_algorithm{GENERATE(
+        ElectionAlgorithm::hirschberg_sinclair,
+        ElectionAlgorithm::peterson
+    )};
+    ExecutionOptions execution_options{GENERATE(
+        ExecutionOptions{false, false, 0},
+        ExecutionOptions{true, false, 2},
+        ExecutionOptions{false, true, 3}
+    )};
+    ElectionRecorder recorder{};
+
+    {
+        Ring ring(
+            30, 
+            0, 
+            &recorder, 
+            WorkerOptions{64, 64, 0, election_algorithm}, 
+            execution_options
+        );
+        ring.start();
+        ring.start_election();
+
+        wait_for_election(recorder);
+
+        ring.stop();
+
+        REQUIRE(recorder.election_finished);
+        CHECK(recorder.leader_id == recorder.highest_id);
+        // at least the Elected Message passes every Worker
+        CHECK(recorder.number_of_election_messages >= 30);
+    }
 }
 
 #endif
@@ -0,0 +1,158 @@
+#include "scheduler.h"
+#include "futex.h"
+#include "timing_wheel.h"
+
+#include <chrono>
+
+using namespace std;
+
+// The Scheduler and the queue the current thread belongs to, if any
+static thread_local Scheduler* current_scheduler{nullptr};
+static thread_local size_t current_queue{0};
+
+
+Scheduler::Scheduler(size_t number_of_threads) {
+    if (number_of_threads == 0) {
+        number_of_threads = max(1u, thread::hardware_concurrency());
+    }
+
+    for (size_t i{0}; i < number_of_threads; i++) {
+        queues.push_back(make_unique<TaskQueue>());
+    }
+    for (size_t i{0}; i < number_of_threads; i++) {
+        threads.push_back(thread{&Scheduler::work, this, i});
+    }
+}
+
+void Scheduler::schedule(Task* task) {
+    number_of_tasks.fetch_add(1);
+    enqueue(task);
+}
+
+void Scheduler::schedule_after(Task* task, unsigned int delay) {
+    if (delay == 0) {
+        schedule(task);
+        return;
+    }
+
+    number_of_tasks.fetch_add(1);
+    TimingWheel::get_instance().schedule(
+        chrono::steady_clock::now() + chrono::milliseconds(delay),
+        [this, task](){ enqueue(task); }
+    );
+}
+
+void Scheduler::enqueue(Task* task) {
+    // a thread of the pool keeps its Tasks, the others spread them
+    size_t index{
+        current_scheduler == this
+        ? current_queue
+        : next_queue.fetch_add(1, memory_order_relaxed) % queues.size()
+    };
+
+    {
+        lock_guard<mutex> queue_lck{queues[index]->queue_mtx};
+        queues[index]->tasks.push_back(task);
+    }
+
+    // pairs with the parking in work,
+    // either the Task is found or the signal has changed
+    work_signal.fetch_add(1);
+    if (number_of_parked_threads.load() > 0) {
+        futex_wake_one(work_signal);
+    }
+}
+
+// Takes the newest Task of the own queue
+// or steals the oldest one of the other queues.
+Task* Scheduler::find_task(size_t own_queue) {
+    {
+        TaskQueue& queue{*queues[own_queue]};
+        lock_guard<mutex> queue_lck{queue.queue_mtx};
+
+        if (!queue.tasks.empty()) {
+            Task* task{queue.tasks.back()};
+            queue.tasks.pop_back();
+            return task;
+        }
+    }
+
+    for (size_t i{1}; i < queues.size(); i++) {
+        TaskQueue& queue{*queues[(own_queue + i) % queues.size()]};
+        lock_guard<mutex> queue_lck{queue.queue_mtx};
+
+        if (!queue.tasks.empty()) {
+            Task* task{queue.tasks.front()};
+            queue.tasks.pop_front();
+            return task;
+        }
+    }
+
+    return nullptr;
+}
+
+void Scheduler::finish_task() {
+    if (number_of_tasks.fetch_sub(1) == 1
+            &&
+        number_of_idle_waiters.load() > 0
+    ) {
+        idle_signal.fetch_add(1);
+        futex_wake_all(idle_signal);
+    }
+}
+
+void Scheduler::work(size_t own_queue) {
+    current_scheduler = this;
+    current_queue = own_queue;
+
+    while (true) {
+        uint32_t observed_signal{work_signal.load()};
+
+        Task* task{find_task(own_queue)};
+        if (task) {
+            task->run();
+            finish_task();
+            continue;
+        }
+
+        if (!running) {
+            break;
+        }
+
+        number_of_parked_threads.fetch_add(1);
+        futex_wait(work_signal, observed_signal);
+        number_of_parked_threads.fetch_sub(1);
+    }
+}
+
+void Scheduler::wait_until_idle() {
+    number_of_idle_waiters.fetch_add(1);
+
+    while (true) {
+        uint32_t observed_signal{idle_signal.load()};
+
+        if (number_of_tasks.load() == 0) {
+            break;
+        }
+
+        futex_wait(idle_signal, observed_signal);
+    }
+
+    number_of_idle_waiters.fetch_sub(1);
+}
+
+size_t Scheduler::get_number_of_threads() const {
+    return threads.size();
+}
+
+Scheduler::~Scheduler() {
+    wait_until_idle();
+
+    running = false;
+    work_signal.fetch_add(1);
+    futex_wake_all(work_signal);
+
+    for (thread& worker_thread : threads) {
+        worker_thread.join();
+    }
+}
@@ -0,0 +1,288 @@
+#include "shard.h"
+#include "futex.h"
+#include "placement.h"
+#include "worker.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+Shard::Shard(size_t index, size_t channel_capacity):
+    index{index},
+    inbound{channel_capacity}
+{}
+
+void Shard::add_worker(Worker* worker) {
+    workers.push_back(worker);
+    worker->shard = this;
+}
+
+void Shard::set_next_shard(Shard* next_shard) {
+    this->next_shard = next_shard;
+}
+
+void Shard::start(int cpu) {
+    this->cpu = cpu;
+    for (Worker* worker : workers) {
+        worker->running = true;
+    }
+    number_of_running_workers = workers.size();
+
+    thread = std::thread{&Shard::work, this};
+}
+
+void Shard::work() {
+    // if it fails, the Shard just isn't pinned
+    pin_current_thread(cpu);
+
+    while (number_of_running_workers > 0) {
+        uint32_t observed_signal{signal.load()};
+        now = chrono::steady_clock::now();
+
+        take_incoming_deliveries();
+        hand_over_overflow();
+        handle_due_deliveries();
+        handle_missed_deliveries();
+
+        if (number_of_running_workers > 0) {
+            park(observed_signal);
+        }
+    }
+}
+
+void Shard::take_incoming_deliveries() {
+    Delivery delivery{};
+    while (inbound.try_pop(delivery)) {
+        queue_locally(delivery);
+    }
+
+    if (has_assigned_deliveries.load()) {
+        lock_guard<mutex> assigned_lck{assigned_mtx};
+
+        for (Delivery& assigned_delivery : assigned_deliveries) {
+            queue_locally(assigned_delivery);
+        }
+        assigned_deliveries.clear();
+        has_assigned_deliveries = false;
+    }
+}
+
+void Shard::hand_over_overflow() {
+    bool has_handed_over{false};
+
+    while (!overflow.empty() && next_shard->inbound.try_push(overflow.front())) {
+        overflow.pop_front();
+        has_handed_over = true;
+    }
+
+    if (has_handed_over) {
+        next_shard->wake();
+    }
+}
+
+// Hands each Worker the Messages due for it as one batch, 
+// like a Worker in its own thread takes them per wakeup.
+void Shard::handle_due_deliveries() {
+    while (!local_deliveries.empty() && local_deliveries.front().due <= now) {
+        LocalDelivery delivery{local_deliveries.front()};
+        local_deliveries.pop_front();
+        Worker* receiver{delivery.receiver};
+
+        if (!receiver->running) {
+            delivery.message.dispose();
+            continue;
+        }
+        if (receiver->shard_wakeup > now || receiver->batch.size() >= receiver->batch_limit) {
+            waiting_deliveries.push_back(delivery);
+            continue;
+        }
+
+        if (delivery.sender && now > delivery.deadline) {
+            report_missed_delivery(delivery.sender, receiver);
+        }
+        if (receiver->batch.empty()) {
+            batched_workers.push_back(receiver);
+        }
+        receiver->batch.push_back(delivery.message);
+    }
+
+    // They are due already, so they stay in front in their order.
+    for (auto delivery{waiting_deliveries.rbegin()}; delivery != waiting_deliveries.rend(); delivery++) {
+        local_deliveries.push_front(*delivery);
+    }
+
+    // Messages sent meanwhile are queued behind them.
+    for (Worker* receiver : batched_workers) {
+        receiver->batch_statistics.add_batch(receiver->batch.size());
+        if (!receiver->act_upon_messages(receiver->batch)) {
+            receiver->running = false;
+            number_of_running_workers--;
+        }
+        else {
+            receiver->handle_lost_segment();
+        }
+        receiver->batch.clear();
+    }
+    batched_workers.clear();
+
+    // the Workers which left Messages behind wake up again a sleeptime later
+    next_due = chrono::steady_clock::time_point::max();
+    for (LocalDelivery& delivery : waiting_deliveries) {
+        Worker* receiver{delivery.receiver};
+        if (receiver->shard_wakeup <= now) {
+            receiver->shard_wakeup = now + chrono::milliseconds(receiver->sleeptime);
+        }
+        next_due = min(next_due, receiver->shard_wakeup);
+    }
+    if (local_deliveries.size() > waiting_deliveries.size()) {
+        next_due = min(next_due, local_deliveries[waiting_deliveries.size()].due);
+    }
+    waiting_deliveries.clear();
+}
+
+// Lets the senders handle the Deliveries missed by their receivers like failed ones.
+void Shard::handle_missed_deliveries() {
+    if (!has_missed_deliveries.load()) {
+        return;
+    }
+
+    vector<MissedDelivery> deliveries{};
+    {
+        lock_guard<mutex> assigned_lck{assigned_mtx};
+        deliveries.swap(missed_deliveries);
+        has_missed_deliveries = false;
+    }
+
+    for (MissedDelivery& delivery : deliveries) {
+        if (delivery.sender->running) {
+            delivery.sender->handle_failed_deliveries({delivery.receiver});
+        }
+    }
+}
+
+void Shard::report_missed_delivery(Worker* sender, Worker* receiver) {
+    Shard* sender_shard{sender->shard};
+    {
+        lock_guard<mutex> assigned_lck{sender_shard->assigned_mtx};
+        sender_shard->missed_deliveries.push_back(MissedDelivery{sender, receiver});
+        sender_shard->has_missed_deliveries = true;
+    }
+
+    if (sender_shard != this) {
+        sender_shard->wake();
+    }
+}
+
+// Also when it's queued after the next due Delivery has been determined,
+// like those sent while handling the missed Deliveries, it's waited for.
+void Shard::queue_locally(const Delivery& delivery) {
+    auto due{now + chrono::milliseconds(delivery.receiver->sleeptime)};
+    next_due = min(next_due, due);
+
+    local_deliveries.push_back(LocalDelivery{
+        due,
+        delivery.receiver,
+        delivery.message,
+        delivery.sender,
+        delivery.deadline
+    });
+}
+
+// Waits for new Messages,
+// but only until the next local Message is due
+// or until the next Shard might have space again.
+void Shard::park(uint32_t observed_signal) {
+    parked = true;
+
+    // pairs with wake, either the signal has changed or the thread is woken
+    if (signal.load() == observed_signal) {
+        if (!overflow.empty()) {
+            futex_wait_for(signal, observed_signal, chrono::milliseconds(1));
+        }
+        else if (!local_deliveries.empty()) {
+            futex_wait_for(signal, observed_signal, next_due - chrono::steady_clock::now());
+        }
+        else {
+            futex_wait(signal, observed_signal);
+        }
+    }
+
+    parked = false;
+}
+
+void Shard::wake() {
+    signal.fetch_add(1);
+    if (parked.load()) {
+        futex_wake_one(signal);
+    }
+}
+
+void Shard::assign(Worker* receiver, const Message& message) {
+    {
+        lock_guard<mutex> assigned_lck{assigned_mtx};
+        assigned_deliveries.push_back(Delivery{receiver, message, nullptr, {}});
+        has_assigned_deliveries = true;
+    }
+
+    wake();
+}
+
+void Shard::send(Worker* sender, Worker* receiver, const Message& message) {
+    Delivery delivery{
+        receiver, 
+        message, 
+        sender, 
+        now + chrono::milliseconds(receiver->get_delivery_waittime())
+    };
+
+    if (receiver->shard == this) {
+        queue_locally(delivery);
+    }
+    else if (receiver->shard == next_shard) {
+        // the order is kept, so nothing overtakes the overflow
+        if (overflow.empty() && next_shard->inbound.try_push(delivery)) {
+            next_shard->wake();
+        }
+        else {
+            overflow.push_back(delivery);
+        }
+    }
+    else {
+        {
+            lock_guard<mutex> assigned_lck{receiver->shard->assigned_mtx};
+            receiver->shard->assigned_deliveries.push_back(delivery);
+            receiver->shard->has_assigned_deliveries = true;
+        }
+        receiver->shard->wake();
+    }
+}
+
+void Shard::join() {
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+Shard::~Shard() {
+    join();
+
+    // Messages which haven't been handled are dropped
+    for (LocalDelivery& delivery : local_deliveries) {
+        delivery.message.dispose();
+    }
+    for (Delivery& delivery : overflow) {
+        delivery.message.dispose();
+    }
+    for (Delivery& delivery : assigned_deliveries) {
+        delivery.message.dispose();
+    }
+    Delivery delivery{};
+    while (inbound.try_pop(delivery)) {
+        delivery.message.dispose();
+    }
+
+    for (Worker* worker : workers) {
+        worker->shard = nullptr;
+    }
+}
@@ -0,0 +1,490 @@
+#include "shm_transport.h"
+#include "futex.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <signal.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+constexpr uint32_t ring_buffer_magic{0x52564f54};
+// the number of records a ring buffer holds
+constexpr uint64_t ring_buffer_capacity{4096};
+// a LogMessage with a longer content is refused
+constexpr size_t record_content_size{56};
+// how often the processes on the other ends are checked
+constexpr chrono::milliseconds check_interval{100};
+// how much longer than its first Worker's delivery waittime
+// the next segment may take nothing, before it's considered dead
+constexpr chrono::milliseconds progress_margin{1000};
+
+
+// A Message as it's written into a ring buffer
+struct Record {
+    uint8_t type;
+    uint8_t content_size;
+    uint16_t epoch;
+    uint32_t id; // or position
+    char content[record_content_size];
+};
+
+static_assert(sizeof(Record) == 64, "a Record needs to fill a cache line");
+
+struct ShmTransport::RingBuffer {
+    // set last, when the ring buffer is ready
+    atomic<uint32_t> magic;
+    // the processes at both ends, 0 while there is none
+    atomic<int32_t> producer_pid;
+    atomic<int32_t> consumer_pid;
+    // the delivery waittime of the consumer's first Worker in ms
+    atomic<uint32_t> delivery_waittime;
+
+    // the next slot to be written, only changed by the producer
+    alignas(64) atomic<uint64_t> head;
+    // the next slot to be read, only changed by the consumer
+    alignas(64) atomic<uint64_t> tail;
+
+    // changed with every new record, the consumer waits on it
+    alignas(64) atomic<uint32_t> data_signal;
+    atomic<uint32_t> consumer_waiting;
+
+    alignas(64) Record records[ring_buffer_capacity];
+};
+
+static_assert(
+    atomic<uint64_t>::is_always_lock_free && atomic<int32_t>::is_always_lock_free,
+    "the atomics in shared memory need to be lock-free"
+);
+
+
+static string get_shm_name(const string& endpoint) {
+    if (endpoint.rfind("shm:", 0) != 0
+            ||
+        endpoint.size() == 4
+            ||
+        endpoint.find('/') != string::npos
+    ) {
+        throw invalid_argument(
+            "The endpoint '" + endpoint + "' isn't 'shm:<name>' with a name without '/'."
+        );
+    }
+
+    return "/ring_voting_" + endpoint.substr(4);
+}
+
+static bool is_process_alive(int32_t pid) {
+    return kill(pid, 0) == 0 || errno == EPERM;
+}
+
+static void* map_ring_buffer(int file_descriptor, size_t size) {
+    void* memory{mmap(
+        nullptr,
+        size,
+        PROT_READ | PROT_WRITE,
+        MAP_SHARED,
+        file_descriptor,
+        0
+    )};
+    close(file_descriptor);
+
+    return memory == MAP_FAILED ? nullptr : memory;
+}
+
+
+ShmTransport::ShmTransport(
+    const string& listen_endpoint,
+    const string& next_endpoint,
+    Presenter* presenter
+): listen_name{get_shm_name(listen_endpoint)},
+   next_name{get_shm_name(next_endpoint)},
+   presenter{presenter}
+{}
+
+void ShmTransport::start(Receiver receiver) {
+    this->receiver = move(receiver);
+
+    // a ring buffer left behind by an earlier run is replaced
+    shm_unlink(listen_name.c_str());
+    int file_descriptor{shm_open(listen_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600)};
+    if (file_descriptor < 0) {
+        throw runtime_error("The ring buffer can't be created: " + string{strerror(errno)});
+    }
+    if (ftruncate(file_descriptor, sizeof(RingBuffer)) != 0) {
+        close(file_descriptor);
+        shm_unlink(listen_name.c_str());
+        throw runtime_error("The ring buffer can't be sized: " + string{strerror(errno)});
+    }
+
+    void* memory{map_ring_buffer(file_descriptor, sizeof(RingBuffer))};
+    if (!memory) {
+        shm_unlink(listen_name.c_str());
+        throw runtime_error("The ring buffer can't be mapped: " + string{strerror(errno)});
+    }
+
+    // the memory is zeroed, only the ends need to be set
+    inbound = static_cast<RingBuffer*>(memory);
+    inbound->consumer_pid = getpid();
+    inbound->delivery_waittime = delivery_waittime;
+    inbound->magic.store(ring_buffer_magic, memory_order_release);
+
+    running = true;
+    reader = thread{&ShmTransport::read, this};
+    sender = thread{&ShmTransport::send_pending, this};
+}
+
+// If a Message of the type can be written as a record.
+// A NewWorker refers to a Worker of this process and a record has no room
+// for the phases and hops of the Messages of Hirschberg and Sinclair and of Peterson.
+static bool is_writable(uint8_t type) {
+    return type > (uint8_t)MessageType::NoMessage
+        && type < (uint8_t)MessageType::NewWorker;
+}
+
+// The other process isn't trusted to write only what a Message can be.
+static bool is_valid(const Record& record) {
+    return is_writable(record.type) && record.content_size <= record_content_size;
+}
+
+static Message to_message(const Record& record) {
+    MessageType type{(MessageType)record.type};
+
+    if (type == MessageType::LogMessage) {
+        return Message::log_message(string_view{record.content, record.content_size});
+    }
+
+    Message message{type};
+    message.id = record.id;
+    message.epoch = record.epoch;
+    return message;
+}
+
+// Takes the records as soon as they are written, frees their slots
+// and only then hands them over to the Receiver,
+// so the producer never waits for the Receiver.
+// Waits on the futex while there are none.
+void ShmTransport::read() {
+    auto last_check{chrono::steady_clock::now()};
+    vector<Message> messages{};
+
+    while (running) {
+        uint64_t tail{inbound->tail.load(memory_order_relaxed)};
+        uint64_t head{inbound->head.load(memory_order_acquire)};
+
+        if (tail != head) {
+            for (; tail != head; tail++) {
+                const Record& record{inbound->records[tail % ring_buffer_capacity]};
+                if (is_valid(record)) {
+                    messages.push_back(to_message(record));
+                }
+            }
+            // frees the slots for the producer
+            inbound->tail.store(tail, memory_order_release);
+
+            for (const Message& message : messages) {
+                receiver(message);
+            }
+            messages.clear();
+            continue;
+        }
+
+        if (chrono::steady_clock::now() - last_check >= check_interval) {
+            check_previous();
+            last_check = chrono::steady_clock::now();
+        }
+
+        // pairs with try_push, either the signal changes or the producer wakes this
+        uint32_t observed_signal{inbound->data_signal.load()};
+        inbound->consumer_waiting.store(1);
+        if (inbound->head.load() == tail && running) {
+            futex_wait_for_shared(inbound->data_signal, observed_signal, check_interval);
+        }
+        inbound->consumer_waiting.store(0);
+    }
+}
+
+// The previous segment's process may be replaced by a new one,
+// the one which is gone is only reported.
+void ShmTransport::check_previous() {
+    int32_t producer_pid{inbound->producer_pid.load()};
+
+    if (producer_pid != 0 && !is_process_alive(producer_pid)) {
+        presenter->log(
+            spdlog::level::warn,
+            "The process of the previous segment is gone."
+        );
+        inbound->producer_pid.compare_exchange_strong(producer_pid, 0);
+    }
+}
+
+// Maps the next segment's ring buffer, once it's ready and its consumer is alive.
+// Returns if it's mapped.
+bool ShmTransport::map_next() {
+    int file_descriptor{shm_open(next_name.c_str(), O_RDWR, 0600)};
+    if (file_descriptor < 0) {
+        return false;
+    }
+
+    struct stat file_status;
+    if (fstat(file_descriptor, &file_status) != 0
+            ||
+        (size_t)file_status.st_size < sizeof(RingBuffer)
+    ) {
+        close(file_descriptor);
+        return false;
+    }
+
+    void* memory{map_ring_buffer(file_descriptor, sizeof(RingBuffer))};
+    if (!memory) {
+        return false;
+    }
+
+    RingBuffer* ring_buffer{static_cast<RingBuffer*>(memory)};
+    if (ring_buffer->magic.load(memory_order_acquire) != ring_buffer_magic) {
+        munmap(memory, sizeof(RingBuffer));
+        return false;
+    }
+
+    // a crashed segment leaves its ring buffer behind,
+    //   it's only taken over once the restarted segment consumes it,
+    //   just as one whose consumer has been lost because it hung
+    int32_t consumer_pid{ring_buffer->consumer_pid.load()};
+    if (consumer_pid == 0 || consumer_pid == lost_consumer_pid || !is_process_alive(consumer_pid)) {
+        munmap(memory, sizeof(RingBuffer));
+        return false;
+    }
+
+    ring_buffer->producer_pid = getpid();
+    outbound = ring_buffer;
+    observed_tail = outbound->tail.load();
+    progress_timeout = chrono::milliseconds(ring_buffer->delivery_waittime.load()) + progress_margin;
+    last_progress = chrono::steady_clock::now();
+
+    return true;
+}
+
+// Lets go of the next segment's ring buffer; only called under the lock.
+void ShmTransport::unmap_next() {
+    int32_t own_pid{getpid()};
+    outbound->producer_pid.compare_exchange_strong(own_pid, 0);
+    munmap(outbound, sizeof(RingBuffer));
+    outbound = nullptr;
+}
+
+// Writes the Message into the next free slot, unless the ring buffer is full;
+// only called under the lock. Returns if it was written.
+bool ShmTransport::try_push(const Message& message) {
+    uint64_t head{outbound->head.load(memory_order_relaxed)};
+    if (head - outbound->tail.load(memory_order_acquire) >= ring_buffer_capacity) {
+        return false;
+    }
+
+    Record& record{outbound->records[head % ring_buffer_capacity]};
+    record.type = (uint8_t)message.type;
+    record.id = message.id;
+    record.epoch = message.epoch;
+    record.content_size = 0;
+    if (message.type == MessageType::LogMessage) {
+        record.content_size = (uint8_t)message.content_size;
+        memcpy(record.content, message.content, record.content_size);
+    }
+
+    outbound->head.store(head + 1);
+    outbound->data_signal.fetch_add(1);
+    if (outbound->consumer_waiting.load()) {
+        futex_wake_all_shared(outbound->data_signal);
+    }
+
+    return true;
+}
+
+void ShmTransport::send(const Message& message) {
+    Message sent_message{message};
+
+    if (!is_writable((uint8_t)message.type)) {
+        presenter->log(
+            spdlog::level::err,
+            "A Message of type " + to_string((int)message.type) 
+                + " can't be sent to the next segment and is dropped"
+        );
+        sent_message.dispose();
+        return;
+    }
+    if (message.type == MessageType::LogMessage && message.content_size > record_content_size) {
+        presenter->log(
+            spdlog::level::err,
+            "A LogMessage of " + to_string(message.content_size) 
+                + " bytes is longer than a record holds and is dropped"
+        );
+        sent_message.dispose();
+        return;
+    }
+
+    {
+        lock_guard<mutex> outgoing_lck{outgoing_mtx};
+
+        if (running && !next_lost) {
+            if (outbound && pending_messages.empty() && try_push(message)) {
+                sent_message.dispose();
+            }
+            else {
+                // written by the sender thread, as soon as there is space
+                pending_messages.push_back(message);
+                outgoing_cv.notify_one();
+            }
+            return;
+        }
+    }
+
+    sent_message.dispose();
+}
+
+// Maps the next segment's ring buffer, writes what didn't fit into it
+// and watches over the next segment.
+// Once it's lost, the ring buffer of the restarted next segment is mapped.
+void ShmTransport::send_pending() {
+    unique_lock<mutex> outgoing_lck{outgoing_mtx};
+
+    while (running) {
+        if (!outbound) {
+            if (!map_next()) {
+                outgoing_cv.wait_for(outgoing_lck, check_interval);
+                continue;
+            }
+            if (next_lost) {
+                next_lost = false;
+                presenter->log(
+                    spdlog::level::warn,
+                    "The process of the next segment has been restarted, "
+                        "so the segment is linked to it again."
+                );
+            }
+        }
+
+        while (!pending_messages.empty() && try_push(pending_messages.front())) {
+            pending_messages.front().dispose();
+            pending_messages.pop_front();
+        }
+
+        check_next();
+
+        outgoing_cv.wait_for(
+            outgoing_lck,
+            pending_messages.empty() ? check_interval : chrono::milliseconds(1)
+        );
+    }
+}
+
+// The next segment is lost when its process is gone or has stopped
+// or when it has records it hasn't taken for the progress timeout,
+// which is as long as its first Worker's delivery waittime and a margin;
+// only called under the lock.
+void ShmTransport::check_next() {
+    int32_t consumer_pid{outbound->consumer_pid.load()};
+    if (consumer_pid == 0) {
+        lose_next("has stopped");
+        return;
+    }
+    if (!is_process_alive(consumer_pid)) {
+        lose_next("is gone");
+        return;
+    }
+
+    uint64_t tail{outbound->tail.load()};
+    if (tail != observed_tail || outbound->head.load() == tail) {
+        observed_tail = tail;
+        last_progress = chrono::steady_clock::now();
+    }
+    else if (chrono::steady_clock::now() - last_progress > progress_timeout) {
+        lose_next("hasn't taken any Message in time");
+    }
+}
+
+// What wasn't written to the next segment is kept for take_lost_next.
+void ShmTransport::lose_next(const string& reason) {
+    next_lost = true;
+    lost_consumer_pid = outbound->consumer_pid.load();
+    unmap_next();
+
+    // behind those of a loss before, which hasn't been taken yet
+    unsent_messages.insert(unsent_messages.end(), pending_messages.begin(), pending_messages.end());
+    pending_messages.clear();
+    is_loss_taken = false;
+
+    presenter->log(
+        spdlog::level::warn,
+        "The process of the next segment " + reason
+            + ", so the segment closes into a ring of its own until it's restarted."
+    );
+}
+
+void ShmTransport::set_delivery_waittime(unsigned int delivery_waittime) {
+    this->delivery_waittime = delivery_waittime;
+}
+
+bool ShmTransport::has_lost_next() const {
+    return next_lost;
+}
+
+bool ShmTransport::take_lost_next(vector<Message>& unsent_messages) {
+    lock_guard<mutex> outgoing_lck{outgoing_mtx};
+
+    if (is_loss_taken) {
+        return false;
+    }
+    is_loss_taken = true;
+
+    unsent_messages.insert(
+        unsent_messages.end(), 
+        this->unsent_messages.begin(), 
+        this->unsent_messages.end()
+    );
+    this->unsent_messages.clear();
+
+    return true;
+}
+
+void ShmTransport::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+
+    {
+        lock_guard<mutex> outgoing_lck{outgoing_mtx};
+        outgoing_cv.notify_all();
+    }
+    inbound->data_signal.fetch_add(1);
+    futex_wake_all_shared(inbound->data_signal);
+
+    reader.join();
+    sender.join();
+
+    for (Message& message : pending_messages) {
+        message.dispose();
+    }
+    pending_messages.clear();
+    for (Message& message : unsent_messages) {
+        message.dispose();
+    }
+    unsent_messages.clear();
+
+    if (outbound) {
+        unmap_next();
+    }
+
+    // tells the previous segment that this one has stopped
+    inbound->consumer_pid = 0;
+    munmap(inbound, sizeof(RingBuffer));
+    inbound = nullptr;
+    shm_unlink(listen_name.c_str());
+}
+
+ShmTransport::~ShmTransport() {
+    stop();
+}
@@ -0,0 +1,175 @@
+#include "simulation.h"
+#include "unique_ids.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+
+Simulation::Simulation(
+    size_t number_of_workers,
+    unsigned int worker_sleeptime,
+    Presenter* presenter,
+    SimulationOptions options
+): ElectionNode{options.election_algorithm},
+   worker_sleeptime{(VirtualTime)worker_sleeptime * 1000},
+   options{options},
+   random_generator{options.seed} {
+    if (!presenter) {
+        presenter = new NoPresenter();
+        owns_presenter = true;
+    }
+    simulation_presenter = presenter;
+    this->presenter = &node_presenter;
+
+    create_nodes(number_of_workers);
+
+    simulation_presenter->ring_created(number_of_workers);
+}
+
+void Simulation::create_nodes(size_t number_of_workers) {
+    nodes.resize(number_of_workers);
+    election_states.resize(number_of_workers);
+    // the ids only depend on the seed, just like the Ring's
+    auto ids{get_unique_ids(
+        number_of_workers, 
+        options.seed, 
+        options.id_layout, 
+        options.number_of_initiators
+    )};
+
+    for (unsigned int i{0}; i < number_of_workers; i++) {
+        election_states[i].id = ids[i];
+        simulation_presenter->worker_created(ids[i], i);
+    }
+}
+
+SimulatedElection Simulation::simulate_election() {
+    election = SimulatedElection{};
+    election_start = now;
+    epoch++;
+
+    // Hirschberg and Sinclair is started by all Workers, the others by the initiators
+    size_t number_of_initiators{
+        options.election_algorithm == ElectionAlgorithm::hirschberg_sinclair
+        ? 0
+        : options.number_of_initiators
+    };
+    for (size_t position : get_initiator_positions(nodes.size(), number_of_initiators)) {
+        receive((uint32_t)position, now, Message::start_election(epoch));
+    }
+
+    while (!events.empty()) {
+        Event event{events.top()};
+        events.pop();
+
+        handle_event(event);
+    }
+
+    simulation_presenter->election_simulated(
+        election.leader_id,
+        election.number_of_proposals,
+        election.number_of_elected_messages,
+        election.latency / 1000.0
+    );
+
+    return election;
+}
+
+void Simulation::handle_event(Event& event) {
+    now = event.time;
+
+    ElectionState& receiver{election_states[event.receiver]};
+    if (enter_epoch(receiver, event.message)) {
+        act_upon_election_message(receiver, event.message);
+    }
+}
+
+// The receiver takes the Message after its next sleep,
+// which begins when it has handled the Messages before.
+// Since the Messages to a node arrive in their order,
+// that's already known when the Message is sent.
+void Simulation::receive(uint32_t receiver, VirtualTime arrival, const Message& message) {
+    VirtualTime& receiver_busy_until{nodes[receiver].busy_until};
+    receiver_busy_until = max(arrival, receiver_busy_until) + worker_sleeptime;
+
+    push_event(receiver_busy_until, receiver, message);
+}
+
+// The Messages of an election are sent in the sender's epoch.
+void Simulation::send_to_neighbour_of(ElectionState& node, const Message& message) {
+    Message sent_message{message};
+    sent_message.epoch = node.epoch;
+
+    uint32_t position{get_position(node)};
+    send(position + 1 == nodes.size() ? 0 : position + 1, sent_message);
+}
+
+void Simulation::send_to_predecessor_of(ElectionState& node, const Message& message) {
+    Message sent_message{message};
+    sent_message.epoch = node.epoch;
+
+    uint32_t position{get_position(node)};
+    send(position == 0 ? (uint32_t)nodes.size() - 1 : position - 1, sent_message);
+}
+
+void Simulation::finish_election(ElectionState& node) {
+    election.is_finished = true;
+    election.leader_id = node.id;
+    election.latency = now - election_start;
+}
+
+// The nodes are stored by their position, which they don't know themselves.
+uint32_t Simulation::get_position(const ElectionState& node) const {
+    return (uint32_t)(&node - election_states.data());
+}
+
+void Simulation::send(uint32_t receiver, const Message& message) {
+    switch (message.type) {
+        case MessageType::ElectionProposal:
+        case MessageType::Probe:
+        case MessageType::Reply:
+        case MessageType::Candidate:
+        case MessageType::PreviousCandidate:
+            election.number_of_proposals++;
+            break;
+        case MessageType::Elected:
+            election.number_of_elected_messages++;
+            break;
+        default:
+            break;
+    }
+
+    VirtualTime arrival{now + options.link_latency};
+    if (options.link_jitter > 0) {
+        arrival += random_generator() % ((uint64_t)options.link_jitter + 1);
+    }
+    // the Messages to a Worker arrive in their order, like the real ones
+    VirtualTime& receiver_last_arrival{nodes[receiver].last_arrival};
+    arrival = max(arrival, receiver_last_arrival);
+    receiver_last_arrival = arrival;
+
+    receive(receiver, arrival, message);
+}
+
+void Simulation::push_event(VirtualTime time, uint32_t receiver, const Message& message) {
+    events.push(Event{time, next_sequence++, receiver, message});
+}
+
+VirtualTime Simulation::get_time() const {
+    return now;
+}
+
+Simulation::~Simulation() {
+    // Messages which are still on their way only need to be disposed
+    while (!events.empty()) {
+        Message message{events.top().message};
+        events.pop();
+        message.dispose();
+    }
+
+    if (owns_presenter) {
+        delete simulation_presenter;
+    }
+}
@@ -0,0 +1,96 @@
+#include "sized_thread.h"
+
+#include <cerrno>
+#include <exception>
+#include <memory>
+#include <system_error>
+#include <utility>
+
+using namespace std;
+
+static void* run_function(void* function);
+
+
+SizedThread::SizedThread(size_t stack_size, function<void()> function) {
+    pthread_attr_t attributes;
+    int error{pthread_attr_init(&attributes)};
+    if (error != 0) {
+        throw system_error{error, generic_category(), "the thread couldn't be started"};
+    }
+    if (stack_size > 0) {
+        // otherwise the attributes keep the default
+        pthread_attr_setstacksize(&attributes, stack_size);
+    }
+
+    auto started_function{make_unique<std::function<void()>>(move(function))};
+    error = pthread_create(&handle, &attributes, run_function, started_function.get());
+    pthread_attr_destroy(&attributes);
+
+    if (error != 0) {
+        throw system_error{error, generic_category(), "the thread couldn't be started"};
+    }
+    // the thread owns it now
+    started_function.release();
+    is_joinable = true;
+}
+
+// The thread deletes the function it has been started with, once it has run it.
+static void* run_function(void* function) {
+    unique_ptr<std::function<void()>> started_function{
+        static_cast<std::function<void()>*>(function)
+    };
+    (*started_function)();
+
+    return nullptr;
+}
+
+SizedThread::SizedThread(SizedThread&& other) noexcept
+: handle{other.handle},
+  is_joinable{exchange(other.is_joinable, false)}
+{}
+
+SizedThread& SizedThread::operator=(SizedThread&& other) noexcept {
+    // like std::thread, a thread which is still running can't be dropped
+    if (is_joinable) {
+        terminate();
+    }
+
+    handle = other.handle;
+    is_joinable = exchange(other.is_joinable, false);
+
+    return *this;
+}
+
+SizedThread::~SizedThread() {
+    if (is_joinable) {
+        terminate();
+    }
+}
+
+bool SizedThread::can_use_stack_size(size_t stack_size) {
+    if (stack_size == 0) {
+        return true;
+    }
+
+    pthread_attr_t attributes;
+    if (pthread_attr_init(&attributes) != 0) {
+        return false;
+    }
+    bool can_use{pthread_attr_setstacksize(&attributes, stack_size) == 0};
+    pthread_attr_destroy(&attributes);
+
+    return can_use;
+}
+
+bool SizedThread::joinable() const {
+    return is_joinable;
+}
+
+void SizedThread::join() {
+    if (!is_joinable) {
+        throw system_error{EINVAL, generic_category(), "the thread isn't joinable"};
+    }
+
+    pthread_join(handle, nullptr);
+    is_joinable = false;
+}
@@ -0,0 +1,410 @@
+#include "socket_transport.h"
+#include "wire_format.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <unistd.h>
+
+using namespace std;
+
+// how much is read from a socket at once
+constexpr size_t read_buffer_size{64 * 1024};
+// how long to wait before connecting to the next segment again
+constexpr chrono::milliseconds retry_delay{100};
+// how many encoded bytes may wait for the next segment, before it's lost
+constexpr size_t max_pending_bytes{4 * 1024 * 1024};
+
+
+SocketTransport::SocketTransport(
+    const string& listen_endpoint,
+    const string& next_endpoint,
+    Presenter* presenter
+): work_guard{asio::make_work_guard(io_context)},
+   acceptor{io_context},
+   inbound{io_context},
+   outbound{io_context},
+   retry_timer{io_context},
+   listen_endpoint{parse_endpoint(listen_endpoint)},
+   next_endpoint{parse_endpoint(next_endpoint)},
+   presenter{presenter},
+   read_buffer(read_buffer_size)
+{
+    if (listen_endpoint.rfind("unix:", 0) == 0) {
+        socket_path = listen_endpoint.substr(5);
+    }
+}
+
+SocketTransport::Protocol::endpoint SocketTransport::parse_endpoint(const string& endpoint) {
+    if (endpoint.rfind("unix:", 0) == 0 && endpoint.size() > 5) {
+        return Protocol::endpoint{asio::local::stream_protocol::endpoint{endpoint.substr(5)}};
+    }
+
+    size_t port_separator{endpoint.rfind(':')};
+    if (endpoint.rfind("tcp:", 0) == 0 && port_separator > 4 && port_separator != string::npos) {
+        try {
+            return Protocol::endpoint{asio::ip::tcp::endpoint{
+                asio::ip::make_address(endpoint.substr(4, port_separator - 4)),
+                (unsigned short)stoul(endpoint.substr(port_separator + 1))
+            }};
+        }
+        catch (const exception&) {
+            // falls through to the error below
+        }
+    }
+
+    throw invalid_argument(
+        "The endpoint '" + endpoint + "' is neither 'unix:<path>' nor 'tcp:<address>:<port>'."
+    );
+}
+
+void SocketTransport::start(Receiver receiver) {
+    this->receiver = move(receiver);
+
+    if (!socket_path.empty()) {
+        // a socket file left behind by an earlier run would block the bind
+        ::unlink(socket_path.c_str());
+    }
+    acceptor.open(listen_endpoint.protocol());
+    if (socket_path.empty()) {
+        acceptor.set_option(asio::socket_base::reuse_address(true));
+    }
+    acceptor.bind(listen_endpoint);
+    acceptor.listen();
+
+    {
+        lock_guard<mutex> outgoing_lck{outgoing_mtx};
+        running = true;
+    }
+
+    accept();
+    connect();
+    io_thread = thread{[this](){ io_context.run(); }};
+}
+
+void SocketTransport::accept() {
+    acceptor.async_accept(inbound, [this](const auto& error) {
+        if (!error) {
+            read();
+        }
+        // otherwise the acceptor has been closed
+    });
+}
+
+void SocketTransport::read() {
+    inbound.async_read_some(
+        asio::buffer(read_buffer),
+        [this](const auto& error, size_t number_of_bytes) {
+            if (error) {
+                presenter->log(
+                    spdlog::level::warn,
+                    "The connection from the previous segment is closed: " + error.message()
+                );
+                inbound.close();
+                incoming_bytes.clear();
+                accept();
+                return;
+            }
+
+            incoming_bytes.insert(
+                incoming_bytes.end(),
+                read_buffer.begin(),
+                read_buffer.begin() + number_of_bytes
+            );
+
+            try {
+                receive_incoming_bytes();
+                read();
+            }
+            catch (const invalid_argument& err) {
+                presenter->log(
+                    spdlog::level::err,
+                    string{"The previous segment sent an invalid Message: "} + err.what()
+                );
+                inbound.close();
+                incoming_bytes.clear();
+                accept();
+            }
+        }
+    );
+}
+
+// Hands all complete Messages over to the Receiver,
+// the bytes of an incomplete one are kept until the rest of it arrives.
+void SocketTransport::receive_incoming_bytes() {
+    size_t offset{0};
+    Message message{};
+
+    while (size_t number_of_bytes{decode_message(
+        incoming_bytes.data() + offset,
+        incoming_bytes.size() - offset,
+        message
+    )}) {
+        offset += number_of_bytes;
+        receiver(message);
+    }
+
+    incoming_bytes.erase(incoming_bytes.begin(), incoming_bytes.begin() + offset);
+}
+
+void SocketTransport::connect() {
+    outbound.async_connect(next_endpoint, [this](const auto& error) {
+        if (error) {
+            outbound.close();
+            retry_timer.expires_after(retry_delay);
+            retry_timer.async_wait([this](const auto& error) {
+                if (!error) {
+                    connect();
+                }
+            });
+            return;
+        }
+
+        bool is_linked_again;
+        {
+            lock_guard<mutex> outgoing_lck{outgoing_mtx};
+            is_connected = true;
+            is_linked_again = next_lost.exchange(false);
+        }
+        if (is_linked_again) {
+            presenter->log(
+                spdlog::level::warn,
+                "The next segment is connected again, so the segment is linked to it again."
+            );
+        }
+
+        watch_next();
+        write();
+    });
+}
+
+// The next segment never sends anything,
+// so a read only completes when it closes the connection,
+// unless the connection is closed by this segment.
+void SocketTransport::watch_next() {
+    outbound.async_read_some(
+        asio::buffer(&watch_byte, 1),
+        [this](const auto& error, size_t) {
+            if (error != asio::error::operation_aborted) {
+                lose_next("has closed the connection");
+            }
+        }
+    );
+}
+
+// Writes all pending bytes at once, unless a write is already in flight;
+// only called by the thread of the sockets.
+void SocketTransport::write() {
+    {
+        lock_guard<mutex> outgoing_lck{outgoing_mtx};
+        if (is_writing || !is_connected || pending_bytes.empty()) {
+            return;
+        }
+
+        swap(pending_bytes, written_bytes);
+        is_writing = true;
+    }
+
+    asio::async_write(
+        outbound,
+        asio::buffer(written_bytes),
+        [this](const auto& error, size_t number_of_bytes) {
+            bool is_lost{false};
+            {
+                lock_guard<mutex> outgoing_lck{outgoing_mtx};
+                if (error) {
+                    // what the next segment hasn't got completely is kept
+                    keep_unsent(written_bytes, number_of_bytes);
+                    keep_unsent(pending_bytes, 0);
+                    pending_bytes.clear();
+                    is_loss_taken = false;
+                    is_connected = false;
+                    is_lost = !next_lost.exchange(true);
+                }
+                written_bytes.clear();
+                is_writing = false;
+            }
+
+            if (error) {
+                // unless it's been lost before, which has closed the connection
+                if (is_lost) {
+                    presenter->log(
+                        spdlog::level::warn,
+                        "The connection to the next segment is closed: " + error.message()
+                            + ", so the segment closes into a ring of its own until it's reconnected."
+                    );
+                }
+                asio::error_code ignored_error;
+                outbound.close(ignored_error);
+                connect();
+                return;
+            }
+
+            write();
+        }
+    );
+}
+
+// What wasn't written to the next segment is kept for take_lost_next;
+// only called by the thread of the sockets.
+// A write in flight is aborted, it keeps its bytes and hands the loss over itself
+// and then it reconnects.
+void SocketTransport::lose_next(const string& reason) {
+    bool was_connected;
+    bool was_writing;
+    {
+        lock_guard<mutex> outgoing_lck{outgoing_mtx};
+        if (next_lost) {
+            return;
+        }
+        next_lost = true;
+        was_connected = is_connected;
+        was_writing = is_writing;
+        is_connected = false;
+
+        if (!is_writing) {
+            keep_unsent(pending_bytes, 0);
+            pending_bytes.clear();
+            is_loss_taken = false;
+        }
+    }
+
+    presenter->log(
+        spdlog::level::warn,
+        "The next segment " + reason
+            + ", so the segment closes into a ring of its own until it's reconnected."
+    );
+
+    // while it isn't connected, it's already being connected to again
+    if (was_connected) {
+        asio::error_code ignored_error;
+        outbound.close(ignored_error);
+        if (!was_writing) {
+            connect();
+        }
+    }
+}
+
+// Decodes the Messages of the bytes which weren't sent completely
+// behind those not sent before; only called under the lock.
+void SocketTransport::keep_unsent(const vector<uint8_t>& bytes, size_t number_of_sent_bytes) {
+    size_t offset{0};
+    Message message{};
+
+    while (size_t number_of_bytes{decode_message(
+        bytes.data() + offset,
+        bytes.size() - offset,
+        message
+    )}) {
+        offset += number_of_bytes;
+        if (offset > number_of_sent_bytes) {
+            unsent_messages.push_back(message);
+        }
+        else {
+            message.dispose();
+        }
+    }
+}
+
+void SocketTransport::send(const Message& message) {
+    bool needs_write{false};
+    bool is_encoded{true};
+    bool is_over_limit{false};
+
+    {
+        lock_guard<mutex> outgoing_lck{outgoing_mtx};
+
+        if (running && !next_lost) {
+            // a write is only started for the first pending Message,
+            // the others are written together with it
+            bool is_first_pending{pending_bytes.empty()};
+            is_encoded = encode_message(message, pending_bytes);
+            needs_write = is_encoded && is_first_pending && is_connected && !is_writing;
+            is_over_limit = pending_bytes.size() > max_pending_bytes;
+        }
+    }
+
+    if (!is_encoded) {
+        presenter->log(
+            spdlog::level::err,
+            "A Message of type " + to_string((int)message.type) 
+                + " can't be sent to the next segment and is dropped"
+        );
+    }
+
+    Message sent_message{message};
+    sent_message.dispose();
+
+    if (needs_write) {
+        asio::post(io_context, [this](){ write(); });
+    }
+    if (is_over_limit) {
+        asio::post(io_context, [this](){
+            {
+                lock_guard<mutex> outgoing_lck{outgoing_mtx};
+                // unless it has been written or lost in the meantime
+                if (pending_bytes.size() <= max_pending_bytes) {
+                    return;
+                }
+            }
+            lose_next("hasn't taken what's sent to it in time");
+        });
+    }
+}
+
+bool SocketTransport::has_lost_next() const {
+    return next_lost;
+}
+
+bool SocketTransport::take_lost_next(vector<Message>& unsent_messages) {
+    lock_guard<mutex> outgoing_lck{outgoing_mtx};
+
+    if (is_loss_taken) {
+        return false;
+    }
+    is_loss_taken = true;
+
+    unsent_messages.insert(
+        unsent_messages.end(), 
+        this->unsent_messages.begin(), 
+        this->unsent_messages.end()
+    );
+    this->unsent_messages.clear();
+
+    return true;
+}
+
+void SocketTransport::stop() {
+    {
+        lock_guard<mutex> outgoing_lck{outgoing_mtx};
+        if (!running) {
+            return;
+        }
+        running = false;
+        pending_bytes.clear();
+    }
+
+    io_context.stop();
+    if (io_thread.joinable()) {
+        io_thread.join();
+    }
+
+    for (Message& message : unsent_messages) {
+        message.dispose();
+    }
+    unsent_messages.clear();
+
+    // the sockets are only closed when their thread doesn't use them anymore
+    asio::error_code ignored_error;
+    retry_timer.cancel();
+    acceptor.close(ignored_error);
+    inbound.close(ignored_error);
+    outbound.close(ignored_error);
+
+    if (!socket_path.empty()) {
+        ::unlink(socket_path.c_str());
+    }
+}
+
+SocketTransport::~SocketTransport() {
+    stop();
+}
@@ -0,0 +1,226 @@
+#include "timing_wheel.h"
+
+using namespace std;
+
+
+TimingWheel::TimingWheel(): start_time{chrono::steady_clock::now()} {
+    ticker = thread{&TimingWheel::tick, this};
+}
+
+TimingWheel& TimingWheel::get_instance() {
+    static TimingWheel instance{};
+    return instance;
+}
+
+TimingWheel::Handle TimingWheel::schedule(
+    chrono::steady_clock::time_point deadline,
+    function<void()> callback
+) {
+    lock_guard<mutex> wheel_lck{wheel_mtx};
+
+    if (number_of_timers == 0) {
+        // an idle wheel doesn't tick, it only needs to catch up
+        current_tick = max(current_tick, get_tick(chrono::steady_clock::now()));
+    }
+
+    Timer* timer;
+    if (free_timers.is_empty()) {
+        timer = new Timer{};
+    }
+    else {
+        timer = free_timers.head.next;
+        unlink(timer);
+    }
+
+    // rounded up, so a Timer never expires before its deadline
+    timer->expiry_tick = max(get_tick(deadline) + 1, current_tick + 1);
+    timer->callback = move(callback);
+    link(timer);
+    number_of_timers++;
+
+    timers_changed.notify_one();
+
+    return {timer, timer->generation};
+}
+
+bool TimingWheel::cancel(Handle handle) {
+    unique_lock<mutex> wheel_lck{wheel_mtx};
+    Timer* timer{handle.timer};
+
+    if (!timer) {
+        return false;
+    }
+
+    timer_fired.wait(wheel_lck, [this, timer, handle](){
+        return firing_timer != timer || timer->generation != handle.generation;
+    });
+
+    if (timer->generation != handle.generation) {
+        return false; // already expired or cancelled
+    }
+
+    unlink(timer);
+    recycle(timer);
+
+    return true;
+}
+
+uint64_t TimingWheel::get_tick(chrono::steady_clock::time_point time) const {
+    if (time <= start_time) {
+        return 0;
+    }
+
+    return chrono::duration_cast<chrono::milliseconds>(time - start_time).count();
+}
+
+void TimingWheel::link(Timer* timer) {
+    uint64_t ticks_left{timer->expiry_tick - current_tick};
+
+    unsigned int level{0};
+    while (level + 1 < number_of_levels
+            &&
+           ticks_left >= (uint64_t{1} << (slot_bits * (level + 1)))
+    ) {
+        level++;
+    }
+
+    append(
+        levels[level][
+            (timer->expiry_tick >> (slot_bits * level)) & (slots_per_level - 1)
+        ],
+        timer
+    );
+}
+
+void TimingWheel::append(Slot& slot, Timer* timer) {
+    timer->previous = slot.head.previous;
+    timer->next = &slot.head;
+    slot.head.previous->next = timer;
+    slot.head.previous = timer;
+}
+
+void TimingWheel::unlink(Timer* timer) {
+    timer->previous->next = timer->next;
+    timer->next->previous = timer->previous;
+    timer->previous = timer->next = nullptr;
+}
+
+void TimingWheel::recycle(Timer* timer) {
+    timer->generation++;
+    timer->callback = nullptr;
+    number_of_timers--;
+
+    timer->previous = &free_timers.head;
+    timer->next = free_timers.head.next;
+    free_timers.head.next->previous = timer;
+    free_timers.head.next = timer;
+}
+
+// Moves the wheel on by one tick and appends the expired Timers to the given Slot.
+void TimingWheel::advance(Slot& expired_timers) {
+    current_tick++;
+
+    // the highest level whose slot boundary is reached by this tick
+    unsigned int highest_level{0};
+    while (highest_level + 1 < number_of_levels
+            &&
+           (current_tick & ((uint64_t{1} << (slot_bits * (highest_level + 1))) - 1)) == 0
+    ) {
+        highest_level++;
+    }
+
+    // cascade the Timers of the reached slots down to lower levels;
+    // they're taken out of the slot first, since a Timer beyond the span
+    // of the highest level is linked into the same slot again
+    for (unsigned int level{highest_level}; level > 0; level--) {
+        Slot& slot{
+            levels[level][
+                (current_tick >> (slot_bits * level)) & (slots_per_level - 1)
+            ]
+        };
+
+        Slot cascading_timers{};
+        while (!slot.is_empty()) {
+            Timer* timer{slot.head.next};
+            unlink(timer);
+            append(cascading_timers, timer);
+        }
+        while (!cascading_timers.is_empty()) {
+            Timer* timer{cascading_timers.head.next};
+            unlink(timer);
+            link(timer);
+        }
+    }
+
+    Slot& slot{levels[0][current_tick & (slots_per_level - 1)]};
+    while (!slot.is_empty()) {
+        Timer* timer{slot.head.next};
+        unlink(timer);
+        append(expired_timers, timer);
+    }
+}
+
+void TimingWheel::tick() {
+    unique_lock<mutex> wheel_lck{wheel_mtx};
+    Slot expired_timers{};
+
+    while (running) {
+        if (number_of_timers == 0) {
+            timers_changed.wait(wheel_lck, [this](){
+                return !running || number_of_timers > 0;
+            });
+            continue;
+        }
+
+        uint64_t now_tick{get_tick(chrono::steady_clock::now())};
+        while (current_tick < now_tick) {
+            advance(expired_timers);
+        }
+
+        while (!expired_timers.is_empty()) {
+            Timer* timer{expired_timers.head.next};
+            unlink(timer);
+            firing_timer = timer;
+
+            // the callback runs without the lock, so it may schedule Timers
+            auto callback{move(timer->callback)};
+            wheel_lck.unlock();
+            callback();
+            wheel_lck.lock();
+
+            firing_timer = nullptr;
+            recycle(timer);
+            timer_fired.notify_all();
+        }
+
+        timers_changed.wait_until(
+            wheel_lck,
+            start_time + chrono::milliseconds(current_tick + 1)
+        );
+    }
+}
+
+TimingWheel::~TimingWheel() {
+    unique_lock<mutex> wheel_lck{wheel_mtx};
+    running = false;
+    timers_changed.notify_one();
+    wheel_lck.unlock();
+
+    ticker.join();
+
+    // Timers which haven't expired are dropped
+    for (auto& level : levels) {
+        for (Slot& slot : level) {
+            while (!slot.is_empty()) {
+                Timer* timer{slot.head.next};
+                unlink(timer);
+                delete timer;
+            }
+        }
+    }
+    while (!free_timers.is_empty()) {
+        Timer* timer{free_timers.head.next};
+        unlink(timer);
+        delete timer;
+    }
+}
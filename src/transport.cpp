@@ -0,0 +1,17 @@
+#include "transport.h"
+#include "shm_transport.h"
+#include "socket_transport.h"
+
+using namespace std;
+
+unique_ptr<Transport> make_transport(
+    const string& listen_endpoint, 
+    const string& next_endpoint, 
+    Presenter* presenter
+) {
+    if (listen_endpoint.rfind("shm:", 0) == 0) {
+        return make_unique<ShmTransport>(listen_endpoint, next_endpoint, presenter);
+    }
+
+    return make_unique<SocketTransport>(listen_endpoint, next_endpoint, presenter);
+}
@@ -0,0 +1,173 @@
+#include "unique_ids.h"
+#include "parallel.h"
+
+#include <algorithm>
+#include <functional>
+
+using namespace std;
+
+// The number of rounds of the Feistel network,
+// 4 rounds are enough for the permutation to look random
+constexpr unsigned int number_of_rounds{4};
+
+
+// A well mixing hash of 64 bits (the finalizer of SplitMix64)
+static uint64_t mix(uint64_t value) {
+    value += 0x9e3779b97f4a7c15;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111eb;
+    return value ^ (value >> 31);
+}
+
+// A keyed bijection of the values below a power of 2,
+// which is a balanced Feistel network over both halves of their bits.
+class FeistelPermutation {
+  private:
+    unsigned int half_bits;
+    uint64_t half_mask;
+    uint64_t keys[number_of_rounds];
+
+  public:
+    FeistelPermutation(uint64_t domain_size, uint64_t seed) {
+        unsigned int bits{2};
+        while (((uint64_t)1 << bits) < domain_size) {
+            bits += 2;
+        }
+        half_bits = bits / 2;
+        half_mask = ((uint64_t)1 << half_bits) - 1;
+
+        for (unsigned int i{0}; i < number_of_rounds; i++) {
+            keys[i] = mix(seed + i);
+        }
+    }
+
+    uint64_t operator()(uint64_t value) const {
+        uint64_t left{value >> half_bits};
+        uint64_t right{value & half_mask};
+
+        for (uint64_t key : keys) {
+            uint64_t new_right{left ^ (mix(right ^ key) & half_mask)};
+            left = right;
+            right = new_right;
+        }
+
+        return (left << half_bits) | right;
+    }
+};
+
+
+vector<unsigned int> get_unique_ids(size_t number_of_ids, uint64_t seed) {
+    uint64_t max_id{
+        number_of_ids < 100
+            ? 999
+            : (uint64_t)number_of_ids * 10
+    };
+    uint64_t domain_size{max_id + 1};
+    FeistelPermutation permutation{domain_size, seed};
+
+    vector<unsigned int> ids(number_of_ids);
+    parallel_for(number_of_ids, [&ids, &permutation, domain_size](size_t begin, size_t end) {
+        for (size_t i{begin}; i < end; i++) {
+            // Cycle-walking keeps the bijection within the domain,
+            // since the permuted domain is at most 4 times larger.
+            uint64_t id{permutation(i)};
+            while (id >= domain_size) {
+                id = permutation(id);
+            }
+            ids[i] = (unsigned int)id;
+        }
+    });
+
+    return ids;
+}
+
+vector<unsigned int> get_unique_ids(
+    size_t number_of_ids, 
+    uint64_t seed, 
+    IdLayout id_layout, 
+    size_t number_of_initiators
+) {
+    vector<unsigned int> ids{get_unique_ids(number_of_ids, seed)};
+
+    switch (id_layout) {
+        case IdLayout::ascending:
+            sort(ids.begin(), ids.end());
+            break;
+        case IdLayout::descending:
+            sort(ids.begin(), ids.end(), greater<unsigned int>());
+            break;
+        case IdLayout::adversarial: {
+            if (ids.empty()) {
+                break;
+            }
+            vector<unsigned int> sorted_ids{ids};
+            sort(sorted_ids.begin(), sorted_ids.end(), greater<unsigned int>());
+
+            // each initiator's proposal travels up to the last position,
+            // which only proposes itself once it's woken up
+            vector<bool> is_taken(number_of_ids, false);
+            size_t next_id{0};
+            auto assign{[&](size_t position) {
+                if (!is_taken[position]) {
+                    ids[position] = sorted_ids[next_id++];
+                    is_taken[position] = true;
+                }
+            }};
+
+            assign(number_of_ids - 1);
+            for (size_t position : get_initiator_positions(number_of_ids, number_of_initiators)) {
+                assign(position);
+            }
+            for (size_t position{0}; position < number_of_ids; position++) {
+                assign(position);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    return ids;
+}
+
+vector<size_t> get_initiator_positions(size_t ring_size, size_t number_of_initiators) {
+    if (number_of_initiators == 0 || number_of_initiators > ring_size) {
+        number_of_initiators = ring_size;
+    }
+
+    vector<size_t> positions(number_of_initiators);
+    for (size_t i{0}; i < number_of_initiators; i++) {
+        positions[i] = i * ring_size / number_of_initiators;
+    }
+
+    return positions;
+}
+
+string to_string(IdLayout id_layout) {
+    switch (id_layout) {
+        case IdLayout::ascending:
+            return "ascending";
+        case IdLayout::descending:
+            return "descending";
+        case IdLayout::adversarial:
+            return "adversarial";
+        default:
+            return "random";
+    }
+}
+
+bool id_layout_from_string(const string& name, IdLayout& id_layout) {
+    for (IdLayout candidate : {
+        IdLayout::random, 
+        IdLayout::ascending, 
+        IdLayout::descending, 
+        IdLayout::adversarial
+    }) {
+        if (name == to_string(candidate)) {
+            id_layout = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
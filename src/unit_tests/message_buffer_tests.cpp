@@ -4,6 +4,7 @@
 #include <chrono>
 #include <tuple>
 #include <thread>
+#include <vector>
 
 // sleep is needed since multiple threads are used
 #define sleep() this_thread::sleep_for(chrono::milliseconds(25))
@@ -20,21 +21,21 @@ TEST_CASE(
     MessageBuffer buffer;
     
     SECTION("messages can't be assigned twice without them beeing taken first") {
-        buffer.assign(new NoMessage());
+        buffer.assign(Message::no_message());
         bool message_taken{false};
 
         thread t{[&](){
             sleep();
             message_taken = true;
-            delete buffer.take();
+            buffer.take();
         }};
 
-        buffer.assign(new NoMessage());
+        buffer.assign(Message::no_message());
 
         CHECK(message_taken);
 
         t.join();
-        delete buffer.take();
+        buffer.take();
     }
 
     SECTION("messages can't be taken before they haven't been assigned first") {
@@ -43,10 +44,10 @@ TEST_CASE(
         thread t{[&](){
             sleep();
             message_assigned = true;
-            buffer.assign(new NoMessage());
+            buffer.assign(Message::no_message());
         }};
 
-        delete buffer.take();
+        buffer.take();
 
         CHECK(message_assigned);
 
@@ -61,23 +62,32 @@ TEST_CASE(
             )
         };
 
-        buffer.assign(new LogMessage(log_msg_content));
+        buffer.assign(Message::log_message(log_msg_content));
 
         auto taken_message{buffer.take()};
 
-        REQUIRE(taken_message->type == MessageType::LogMessage);
-        CHECK(taken_message->cast_to<LogMessage>()->content == log_msg_content);
+        REQUIRE(taken_message.type == MessageType::LogMessage);
+        CHECK(taken_message.get_content() == log_msg_content);
 
-        delete taken_message;
+        taken_message.dispose();
     }
 
     SECTION("is_empty holds true when the buffer has no message assigned") {
         REQUIRE(buffer.is_empty());
 
-        buffer.assign(new NoMessage());
+        buffer.assign(Message::no_message());
         CHECK_FALSE(buffer.is_empty());
 
-        delete buffer.take();
+        buffer.take();
+        CHECK(buffer.is_empty());
+    }
+
+    SECTION("take_all takes exactly one message") {
+        vector<Message> messages{};
+        buffer.assign(Message::no_message());
+
+        CHECK(buffer.take_all(messages, 10) == 1);
+        CHECK(messages.size() == 1);
         CHECK(buffer.is_empty());
     }
 
@@ -87,40 +97,50 @@ TEST_CASE(
         thread t{[&](){
             sleep();
             message_taken = true;
-            delete buffer.take();
+            buffer.take();
         }};
 
-        CHECK(buffer.assign_and_wait(new NoMessage(), waittime));
+        CHECK(buffer.assign_and_wait(Message::no_message(), waittime));
 
         CHECK(message_taken);
 
         t.join();
     }
 
+    SECTION("assign_sync times out when the message isn't taken in time") {
+        auto start{chrono::steady_clock::now()};
+
+        CHECK_FALSE(buffer.assign_and_wait(Message::no_message(), waittime));
+        CHECK(chrono::steady_clock::now() - start >= chrono::milliseconds(waittime));
+        CHECK_FALSE(buffer.is_empty());
+
+        buffer.take();
+    }
+
     SECTION("multiple assign_sync calls are handled in the calling order") {
         bool first_message_taken{false};
         bool second_message_taken{false};
 
         thread t1{[&](){
             sleep();
-            CHECK(buffer.assign_and_wait(new NoMessage(), waittime));
+            CHECK(buffer.assign_and_wait(Message::no_message(), waittime));
             first_message_taken = true;
         }};
         thread t2{[&](){
             sleep_more(2);
-            CHECK(buffer.assign_and_wait(new NoMessage(), waittime));
+            CHECK(buffer.assign_and_wait(Message::no_message(), waittime));
             second_message_taken = true;
         }};
 
         sleep_more(3);
 
-        delete buffer.take();
+        buffer.take();
         sleep();
 
         CHECK(first_message_taken);
         CHECK_FALSE(second_message_taken);
 
-        delete buffer.take();
+        buffer.take();
         sleep();
 
         CHECK(second_message_taken);
@@ -135,26 +155,241 @@ TEST_CASE(
 
         thread t1{[&](){
             sleep();
-            CHECK(buffer.assign_and_wait(new NoMessage(), waittime));
+            CHECK(buffer.assign_and_wait(Message::no_message(), waittime));
             first_message_taken = true;
         }};
         thread t2{[&](){
             sleep_more(2);
-            buffer.assign(new NoMessage());
+            buffer.assign(Message::no_message());
             second_message_assigned = true;
         }};
 
         sleep_more(3);
 
-        delete buffer.take();
+        buffer.take();
         sleep();
 
         CHECK(first_message_taken);
         CHECK(second_message_assigned);
 
-        delete buffer.take();
+        buffer.take();
 
         t1.join();
         t2.join();
     }
 }
+
+TEST_CASE(
+    "Message Buffer with a capacity above 1 queues Messages of multiple producers", 
+    "[message_buffer][message_queue]"
+) {
+    unsigned int waittime{100}; // ms
+    size_t capacity{GENERATE(2, 5, 64)};
+    MessageBuffer buffer(capacity);
+
+    SECTION("the capacity is rounded up to a power of 2") {
+        size_t buffer_capacity{buffer.get_capacity()};
+
+        CHECK(buffer_capacity >= capacity);
+        CHECK((buffer_capacity & (buffer_capacity - 1)) == 0);
+    }
+
+    SECTION("messages can be assigned without them beeing taken until the buffer is full") {
+        for (size_t i{0}; i < buffer.get_capacity(); i++) {
+            buffer.assign(Message::election_proposal(i));
+        }
+
+        CHECK_FALSE(buffer.is_empty());
+
+        for (size_t i{0}; i < buffer.get_capacity(); i++) {
+            auto message{buffer.take()};
+            REQUIRE(message.type == MessageType::ElectionProposal);
+            CHECK(message.id == i);
+        }
+
+        CHECK(buffer.is_empty());
+    }
+
+    SECTION("messages can't be taken before they haven't been assigned first") {
+        bool message_assigned{false};
+
+        thread t{[&](){
+            sleep();
+            message_assigned = true;
+            buffer.assign(Message::no_message());
+        }};
+
+        buffer.take();
+
+        CHECK(message_assigned);
+
+        t.join();
+    }
+
+    SECTION("take_all takes all queued messages in order up to the limit") {
+        size_t limit{GENERATE(1, 3, 100)};
+        size_t number_of_messages{buffer.get_capacity()};
+        for (size_t i{0}; i < number_of_messages; i++) {
+            buffer.assign(Message::election_proposal(i));
+        }
+
+        vector<Message> messages{};
+        while (messages.size() < number_of_messages) {
+            size_t expected_batch_size{
+                min(limit, number_of_messages - messages.size())
+            };
+            CHECK(buffer.take_all(messages, limit) == expected_batch_size);
+        }
+
+        CHECK(buffer.is_empty());
+        for (size_t i{0}; i < number_of_messages; i++) {
+            REQUIRE(messages[i].type == MessageType::ElectionProposal);
+            CHECK(messages[i].id == i);
+        }
+    }
+
+    SECTION("take_all blocks until there is a message") {
+        bool message_assigned{false};
+
+        thread t{[&](){
+            sleep();
+            message_assigned = true;
+            buffer.assign(Message::no_message());
+        }};
+
+        vector<Message> messages{};
+        CHECK(buffer.take_all(messages, 10) == 1);
+        CHECK(message_assigned);
+
+        t.join();
+    }
+
+    SECTION("producers block on a full buffer until a message is taken") {
+        for (size_t i{0}; i < buffer.get_capacity(); i++) {
+            buffer.assign(Message::no_message());
+        }
+        bool message_taken{false};
+
+        thread t{[&](){
+            sleep();
+            message_taken = true;
+            buffer.take();
+        }};
+
+        buffer.assign(Message::no_message());
+
+        CHECK(message_taken);
+
+        t.join();
+        while (!buffer.is_empty()) {
+            buffer.take();
+        }
+    }
+
+    SECTION("messages of multiple producers are all taken in their producers' order") {
+        unsigned int number_of_producers{4};
+        unsigned int messages_per_producer{500};
+        vector<thread> producers{};
+
+        for (unsigned int p{0}; p < number_of_producers; p++) {
+            producers.emplace_back([&, p](){
+                for (unsigned int i{0}; i < messages_per_producer; i++) {
+                    buffer.assign(Message::election_proposal(p * messages_per_producer + i));
+                }
+            });
+        }
+
+        vector<unsigned int> next_index(number_of_producers, 0);
+        for (unsigned int i{0}; i < number_of_producers * messages_per_producer; i++) {
+            auto message{buffer.take()};
+            REQUIRE(message.type == MessageType::ElectionProposal);
+
+            unsigned int id{message.id};
+            unsigned int producer{id / messages_per_producer};
+            REQUIRE(id % messages_per_producer == next_index[producer]);
+            next_index[producer]++;
+        }
+
+        for (auto& producer : producers) {
+            producer.join();
+        }
+
+        CHECK(buffer.is_empty());
+    }
+
+    SECTION("assign_and_wait waits for the message to be taken") {
+        bool message_taken{false};
+
+        thread t{[&](){
+            sleep();
+            message_taken = true;
+            buffer.take();
+        }};
+
+        CHECK(buffer.assign_and_wait(Message::no_message(), waittime));
+
+        CHECK(message_taken);
+
+        t.join();
+    }
+
+    SECTION("assign_and_wait times out when the message isn't taken") {
+        CHECK_FALSE(buffer.assign_and_wait(Message::no_message(), waittime));
+
+        buffer.take();
+    }
+
+    SECTION("assign_and_wait waits for all messages queued before its own") {
+        buffer.assign(Message::no_message());
+        bool second_message_taken{false};
+
+        thread t{[&](){
+            CHECK(buffer.assign_and_wait(Message::no_message(), waittime));
+            second_message_taken = true;
+        }};
+
+        sleep();
+        buffer.take();
+        sleep();
+
+        CHECK_FALSE(second_message_taken);
+
+        buffer.take();
+        t.join();
+
+        CHECK(second_message_taken);
+    }
+}
+
+TEST_CASE(
+    "Message Buffer with a spin limit takes Messages before and after it parks", 
+    "[message_buffer]"
+) {
+    size_t capacity{GENERATE(1, 64)};
+    MessageBuffer buffer(capacity, 10000);
+
+    SECTION("a message assigned while spinning is taken") {
+        thread t{[&](){
+            buffer.assign(Message::election_proposal(1));
+        }};
+
+        auto message{buffer.take()};
+        CHECK(message.type == MessageType::ElectionProposal);
+        CHECK(message.id == 1);
+
+        t.join();
+    }
+
+    SECTION("a message assigned after spinning wakes the parked taker") {
+        thread t{[&](){
+            sleep();
+            buffer.assign(Message::election_proposal(2));
+        }};
+
+        vector<Message> messages{};
+        CHECK(buffer.take_all(messages, 10) == 1);
+        CHECK(messages[0].id == 2);
+
+        t.join();
+    }
+}
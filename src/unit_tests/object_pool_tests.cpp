@@ -0,0 +1,135 @@
+#include "object_pool.h"
+
+#include "catch2/catch.hpp"
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+// a type of its own, so the tests don't share a Pool with other code
+struct PooledProbe {
+    unsigned int value;
+    string name;
+};
+
+TEST_CASE(
+    "Object Pool creates and destroys objects without growing once warm",
+    "[object_pool]"
+) {
+    PoolStatistics before{ObjectPool<PooledProbe>::get_statistics()};
+
+    SECTION("created objects hold the given values") {
+        PooledProbe* probe{ObjectPool<PooledProbe>::create(PooledProbe{42, "probe"})};
+
+        CHECK(probe->value == 42);
+        CHECK(probe->name == "probe");
+        CHECK(ObjectPool<PooledProbe>::get_statistics().live_objects == before.live_objects + 1);
+
+        ObjectPool<PooledProbe>::destroy(probe);
+        CHECK(ObjectPool<PooledProbe>::get_statistics().live_objects == before.live_objects);
+    }
+
+    SECTION("destroyed objects make room for new ones") {
+        vector<PooledProbe*> probes{};
+        for (unsigned int round{0}; round < 10; round++) {
+            for (unsigned int i{0}; i < 500; i++) {
+                probes.push_back(ObjectPool<PooledProbe>::create(PooledProbe{i, ""}));
+            }
+
+            set<PooledProbe*> distinct_probes{probes.begin(), probes.end()};
+            CHECK(distinct_probes.size() == probes.size());
+
+            for (PooledProbe* probe : probes) {
+                ObjectPool<PooledProbe>::destroy(probe);
+            }
+            probes.clear();
+        }
+
+        PoolStatistics after{ObjectPool<PooledProbe>::get_statistics()};
+        CHECK(after.live_objects == before.live_objects);
+        CHECK(after.high_water_mark >= 500);
+        // the rounds after the first one reuse the room of the first one
+        CHECK(after.reserved_objects <= max(before.reserved_objects, size_t{500 + 64}));
+    }
+
+    SECTION("objects destroyed by another thread are counted and reused") {
+        vector<PooledProbe*> probes{};
+        for (unsigned int i{0}; i < 300; i++) {
+            probes.push_back(ObjectPool<PooledProbe>::create(PooledProbe{i, ""}));
+        }
+
+        thread destroyer{[&](){
+            for (PooledProbe* probe : probes) {
+                ObjectPool<PooledProbe>::destroy(probe);
+            }
+        }};
+        destroyer.join();
+
+        PoolStatistics after{ObjectPool<PooledProbe>::get_statistics()};
+        CHECK(after.live_objects == before.live_objects);
+        CHECK(after.cross_thread_frees == before.cross_thread_frees + 300);
+
+        // the destroying thread has returned its free list on exit
+        for (unsigned int i{0}; i < 300; i++) {
+            probes[i] = ObjectPool<PooledProbe>::create(PooledProbe{i, ""});
+        }
+        CHECK(ObjectPool<PooledProbe>::get_statistics().reserved_objects == after.reserved_objects);
+
+        for (PooledProbe* probe : probes) {
+            ObjectPool<PooledProbe>::destroy(probe);
+        }
+    }
+}
+
+TEST_CASE(
+    "Buffer Pool takes buffers of each size class without growing once warm",
+    "[object_pool]"
+) {
+    for (size_t size_class{0}; size_class < BufferPool::number_of_size_classes; size_class++) {
+        size_t capacity{BufferPool::get_capacity(size_class)};
+        PoolStatistics before{BufferPool::get_statistics(size_class)};
+
+        for (unsigned int round{0}; round < 3; round++) {
+            char* buffer{BufferPool::create(capacity)};
+            buffer[0] = 'a';
+            buffer[capacity - 1] = 'z';
+            BufferPool::destroy(buffer, capacity);
+        }
+
+        PoolStatistics after{BufferPool::get_statistics(size_class)};
+        CHECK(after.live_objects == before.live_objects);
+        CHECK(after.high_water_mark >= 1);
+        CHECK(after.reserved_objects <= max(before.reserved_objects, size_t{64}));
+    }
+
+    // a smaller size takes a buffer of the smallest class it fits into
+    PoolStatistics before{BufferPool::get_statistics(1)};
+    char* buffer{BufferPool::create(BufferPool::get_capacity(0) + 1)};
+    CHECK(BufferPool::get_statistics(1).live_objects == before.live_objects + 1);
+    BufferPool::destroy(buffer, BufferPool::get_capacity(0) + 1);
+    CHECK(BufferPool::get_statistics(1).live_objects == before.live_objects);
+}
+
+TEST_CASE(
+    "Buffer Pool reserves large buffers only a few at a time",
+    "[object_pool]"
+) {
+    size_t largest_class{BufferPool::number_of_size_classes - 1};
+    PoolStatistics before{BufferPool::get_statistics(largest_class)};
+
+    // a new thread starts with an empty free list
+    thread creator{[](){
+        char* buffer{BufferPool::create(BufferPool::max_capacity)};
+        BufferPool::destroy(buffer, BufferPool::max_capacity);
+    }};
+    creator.join();
+
+    CHECK(
+        BufferPool::get_statistics(largest_class).reserved_objects 
+            <= 
+        before.reserved_objects + 1
+    );
+}
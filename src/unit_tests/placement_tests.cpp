@@ -0,0 +1,60 @@
+#include "placement.h"
+
+#include "catch2/catch.hpp"
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+TEST_CASE("Placements are named like they are configured", "[placement]") {
+    Placement placement{GENERATE(Placement::none, Placement::compact, Placement::scatter)};
+    Placement parsed_placement{Placement::none};
+
+    REQUIRE(placement_from_string(to_string(placement), parsed_placement));
+    CHECK(parsed_placement == placement);
+    CHECK_FALSE(placement_from_string("diagonal", parsed_placement));
+}
+
+TEST_CASE("get_cpu_for_position places the positions according to the Placement", "[placement]") {
+    vector<int> cpus{4, 5, 0, 1};
+
+    SECTION("compact places contiguous blocks of positions on the same CPU") {
+        vector<int> placed_cpus{};
+        for (size_t position{0}; position < 8; position++) {
+            placed_cpus.push_back(get_cpu_for_position(Placement::compact, position, 8, cpus));
+        }
+
+        CHECK(placed_cpus == vector<int>{4, 4, 5, 5, 0, 0, 1, 1});
+    }
+
+    SECTION("scatter places neighbouring positions on different CPUs") {
+        vector<int> placed_cpus{};
+        for (size_t position{0}; position < 6; position++) {
+            placed_cpus.push_back(get_cpu_for_position(Placement::scatter, position, 6, cpus));
+        }
+
+        CHECK(placed_cpus == vector<int>{4, 5, 0, 1, 4, 5});
+    }
+
+    SECTION("none and no CPUs place nothing") {
+        CHECK(get_cpu_for_position(Placement::none, 3, 8, cpus) == -1);
+        CHECK(get_cpu_for_position(Placement::compact, 3, 8, {}) == -1);
+    }
+}
+
+#ifdef __linux__
+TEST_CASE("get_ordered_cpus returns each CPU the process may run on once", "[placement]") {
+    vector<int> cpus{get_ordered_cpus()};
+    set<int> unique_cpus{cpus.begin(), cpus.end()};
+
+    CHECK_FALSE(cpus.empty());
+    CHECK(unique_cpus.size() == cpus.size());
+
+    // in a thread of its own, so the other tests' threads aren't pinned
+    bool is_pinned{false};
+    thread{[&is_pinned, &cpus](){ is_pinned = pin_current_thread(cpus.front()); }}.join();
+    CHECK(is_pinned);
+}
+#endif
@@ -0,0 +1,114 @@
+#include "scheduler.h"
+
+#include "catch2/catch.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+// A Task which counts its runs and schedules itself again a number of times
+class CountingTask: public Task {
+  public:
+    Scheduler* scheduler{nullptr};
+    atomic<unsigned int> number_of_runs{0};
+    unsigned int number_of_reschedules{0};
+    unsigned int delay{0}; // in ms
+
+    mutex threads_mtx;
+    set<thread::id> threads{};
+
+    void run() override {
+        number_of_runs++;
+        {
+            lock_guard<mutex> threads_lck{threads_mtx};
+            threads.insert(this_thread::get_id());
+        }
+
+        if (number_of_reschedules > 0) {
+            number_of_reschedules--;
+            scheduler->schedule_after(this, delay);
+        }
+    }
+};
+
+// A Task which schedules another Task on its own queue 
+// and then blocks its thread for a while
+class SpawningTask: public Task {
+  public:
+    Scheduler* scheduler{nullptr};
+    Task* spawned_task{nullptr};
+    atomic<bool> has_run{false};
+    thread::id thread_id{};
+
+    void run() override {
+        thread_id = this_thread::get_id();
+        scheduler->schedule(spawned_task);
+        this_thread::sleep_for(chrono::milliseconds(50));
+        has_run = true;
+    }
+};
+
+TEST_CASE(
+    "Scheduler runs the scheduled Tasks on its threads",
+    "[scheduler]"
+) {
+    SECTION("the number of threads defaults to the number of cores") {
+        Scheduler scheduler{};
+
+        CHECK(scheduler.get_number_of_threads() == max(1u, thread::hardware_concurrency()));
+    }
+
+    SECTION("every scheduled Task is run once per scheduling") {
+        Scheduler scheduler{4};
+        vector<CountingTask> tasks(100);
+
+        for (CountingTask& task : tasks) {
+            task.scheduler = &scheduler;
+            task.number_of_reschedules = 9;
+            scheduler.schedule(&task);
+        }
+        scheduler.wait_until_idle();
+
+        for (CountingTask& task : tasks) {
+            CHECK(task.number_of_runs == 10);
+        }
+    }
+
+    SECTION("a delayed Task counts as scheduled until it has run") {
+        Scheduler scheduler{2};
+        CountingTask task{};
+        task.scheduler = &scheduler;
+        task.number_of_reschedules = 1;
+        task.delay = 50;
+
+        auto start{chrono::steady_clock::now()};
+        scheduler.schedule(&task);
+        scheduler.wait_until_idle();
+
+        CHECK(task.number_of_runs == 2);
+        CHECK(chrono::steady_clock::now() - start >= chrono::milliseconds(50));
+    }
+
+    SECTION("idle threads steal the Tasks queued behind a blocked one") {
+        Scheduler scheduler{2};
+        CountingTask task{};
+        SpawningTask spawning_task{};
+        spawning_task.scheduler = &scheduler;
+        spawning_task.spawned_task = &task;
+
+        scheduler.schedule(&spawning_task);
+        this_thread::sleep_for(chrono::milliseconds(25));
+
+        CHECK(task.number_of_runs == 1);
+        CHECK_FALSE(spawning_task.has_run);
+
+        scheduler.wait_until_idle();
+        CHECK(spawning_task.has_run);
+        CHECK(task.threads.count(spawning_task.thread_id) == 0);
+    }
+}
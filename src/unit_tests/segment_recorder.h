@@ -0,0 +1,48 @@
+#pragma once
+
+#include "presenters/no_presenter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Shared by the tests of Rings spread over segments linked by a Transport.
+
+// A Presenter which records the highest id created and the leader elected
+class SegmentRecorder: public NoPresenter {
+  public:
+    unsigned int highest_id{0};
+    std::atomic<unsigned int> leader_id{0};
+    std::atomic<bool> election_finished{false};
+
+    void worker_created(unsigned int worker_id, unsigned int) override {
+        highest_id = std::max(highest_id, worker_id);
+    }
+
+    void election_is_finished(unsigned int leader_id) override {
+        this->leader_id = leader_id;
+        election_finished = true;
+    }
+};
+
+// A Presenter which records the dead neighbours recognized, besides the election
+class DeadNeighbourRecorder: public SegmentRecorder {
+  public:
+    std::atomic<size_t> number_of_dead_neighbours{0};
+
+    void worker_recognizes_dead_neighbour(unsigned int, unsigned int) override {
+        number_of_dead_neighbours++;
+    }
+};
+
+// Waits until the predicate holds or the timeout has passed.
+// Returns if the predicate holds.
+template<typename Predicate>
+inline bool wait_until(Predicate predicate, std::chrono::milliseconds timeout) {
+    auto deadline{std::chrono::steady_clock::now() + timeout};
+    while (!predicate() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return predicate();
+}
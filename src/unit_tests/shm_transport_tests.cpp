@@ -0,0 +1,288 @@
+#include "shm_transport.h"
+#include "ring.h"
+#include "presenters/no_presenter.h"
+#include "segment_recorder.h"
+
+#include "catch2/catch.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+
+// Unique shared memory names per test process
+static string get_shm_endpoint(const string& name) {
+    return "shm:test_" + to_string(getpid()) + "_" + name;
+}
+
+TEST_CASE("ShmTransport only takes shm endpoints", "[shm_transport]") {
+    NoPresenter presenter{};
+
+    CHECK_NOTHROW(ShmTransport("shm:first", "shm:second", &presenter));
+
+    CHECK_THROWS_AS(ShmTransport("shm:", "shm:second", &presenter), invalid_argument);
+    CHECK_THROWS_AS(ShmTransport("shm:first", "shm:a/b", &presenter), invalid_argument);
+    CHECK_THROWS_AS(ShmTransport("unix:/tmp/first", "shm:second", &presenter), invalid_argument);
+}
+
+TEST_CASE("ShmTransports deliver the Messages sent in their order", "[shm_transport]") {
+    string endpoint{get_shm_endpoint("order")};
+    NoPresenter presenter{};
+
+    // one Transport sends to itself, more than fits into its ring buffer
+    ShmTransport transport{endpoint, endpoint, &presenter};
+    vector<unsigned int> ids{};
+    string content{};
+    atomic<size_t> number_of_received_messages{0};
+    transport.start([&](const Message& message) {
+        if (message.type == MessageType::LogMessage) {
+            content = message.get_content();
+            Message{message}.dispose();
+        }
+        else {
+            ids.push_back(message.id);
+        }
+        number_of_received_messages++;
+    });
+
+    for (unsigned int id{0}; id < 10000; id++) {
+        transport.send(Message::election_proposal(id));
+    }
+    transport.send(Message::log_message(string(56, 'x')));
+
+    wait_until([&](){ return number_of_received_messages == 10001; }, chrono::seconds(5));
+    transport.stop();
+
+    REQUIRE(ids.size() == 10000);
+    for (unsigned int id{0}; id < 10000; id++) {
+        CHECK(ids[id] == id);
+    }
+    // a content which fills the whole record arrives complete
+    CHECK(content == string(56, 'x'));
+}
+
+// A Presenter which counts the errors logged
+class ErrorCounter: public NoPresenter {
+  public:
+    atomic<size_t> number_of_errors{0};
+
+    void log(spdlog::level::level_enum log_level, const string&) override {
+        if (log_level == spdlog::level::err) {
+            number_of_errors++;
+        }
+    }
+};
+
+TEST_CASE(
+    "An ShmTransport refuses the Messages a record can't hold with an error", 
+    "[shm_transport]"
+) {
+    string endpoint{get_shm_endpoint("refused")};
+    ErrorCounter presenter{};
+
+    ShmTransport transport{endpoint, endpoint, &presenter};
+    vector<MessageType> types{};
+    atomic<size_t> number_of_received_messages{0};
+    transport.start([&](const Message& message) {
+        types.push_back(message.type);
+        number_of_received_messages++;
+    });
+
+    transport.send(Message::probe(3, 1, 1, false));
+    transport.send(Message::reply(3, 1, true));
+    transport.send(Message::candidate(3, 1));
+    transport.send(Message::previous_candidate(3, 1));
+    transport.send(Message::new_worker(0, nullptr));
+    // a longer content isn't cut off
+    transport.send(Message::log_message(string(57, 'x')));
+    transport.send(Message::election_proposal(3));
+
+    REQUIRE(wait_until([&](){ return number_of_received_messages == 1; }, chrono::seconds(5)));
+    transport.stop();
+
+    CHECK(types == vector<MessageType>{MessageType::ElectionProposal});
+    CHECK(presenter.number_of_errors == 6);
+}
+
+TEST_CASE("An ShmTransport loses the next segment when it stops", "[shm_transport]") {
+    string first_endpoint{get_shm_endpoint("first")};
+    string second_endpoint{get_shm_endpoint("second")};
+    NoPresenter presenter{};
+
+    ShmTransport first{first_endpoint, second_endpoint, &presenter};
+    ShmTransport second{second_endpoint, first_endpoint, &presenter};
+    atomic<bool> received{false};
+    first.start([](const Message&){});
+    second.start([&](const Message&){ received = true; });
+
+    first.send(Message::start_election());
+    REQUIRE(wait_until([&](){ return received.load(); }, chrono::seconds(5)));
+    CHECK_FALSE(first.has_lost_next());
+
+    second.stop();
+
+    CHECK(wait_until([&](){ return first.has_lost_next(); }, chrono::seconds(2)));
+    // the loss is taken once
+    vector<Message> unsent_messages{};
+    CHECK(first.take_lost_next(unsent_messages));
+    CHECK_FALSE(first.take_lost_next(unsent_messages));
+    first.stop();
+}
+
+TEST_CASE("An ShmTransport links to the restarted next segment again", "[shm_transport]") {
+    string first_endpoint{get_shm_endpoint("rejoin_first")};
+    string second_endpoint{get_shm_endpoint("rejoin_second")};
+    NoPresenter presenter{};
+
+    ShmTransport first{first_endpoint, second_endpoint, &presenter};
+    first.start([](const Message&){});
+    {
+        ShmTransport second{second_endpoint, first_endpoint, &presenter};
+        second.start([](const Message&){});
+        first.send(Message::start_election());
+        this_thread::sleep_for(chrono::milliseconds(300));
+    }
+    REQUIRE(wait_until([&](){ return first.has_lost_next(); }, chrono::seconds(2)));
+
+    ShmTransport restarted_second{second_endpoint, first_endpoint, &presenter};
+    atomic<bool> received{false};
+    restarted_second.start([&](const Message&){ received = true; });
+
+    REQUIRE(wait_until([&](){ return !first.has_lost_next(); }, chrono::seconds(2)));
+    first.send(Message::start_election());
+    CHECK(wait_until([&](){ return received.load(); }, chrono::seconds(5)));
+
+    first.stop();
+    restarted_second.stop();
+}
+
+TEST_CASE(
+    "An ShmTransport waits for the restart of a next segment which crashed", 
+    "[shm_transport]"
+) {
+    string first_endpoint{get_shm_endpoint("crashed_first")};
+    string second_endpoint{get_shm_endpoint("crashed_second")};
+    NoPresenter presenter{};
+
+    // the crashed segment leaves its ring buffer behind
+    pid_t crashed_pid{fork()};
+    if (crashed_pid == 0) {
+        ShmTransport crashed{second_endpoint, first_endpoint, &presenter};
+        crashed.start([](const Message&){});
+        _exit(0);
+    }
+    REQUIRE(crashed_pid > 0);
+    waitpid(crashed_pid, nullptr, 0);
+
+    ShmTransport first{first_endpoint, second_endpoint, &presenter};
+    first.start([](const Message&){});
+    this_thread::sleep_for(chrono::milliseconds(300));
+    CHECK_FALSE(first.has_lost_next());
+
+    ShmTransport second{second_endpoint, first_endpoint, &presenter};
+    atomic<bool> received{false};
+    second.start([&](const Message&){ received = true; });
+    first.send(Message::start_election());
+
+    CHECK(wait_until([&](){ return received.load(); }, chrono::seconds(5)));
+    CHECK_FALSE(first.has_lost_next());
+
+    first.stop();
+    second.stop();
+}
+
+TEST_CASE(
+    "An ShmTransport grants the next segment its delivery waittime to take Messages", 
+    "[shm_transport]"
+) {
+    string first_endpoint{get_shm_endpoint("patient_first")};
+    string second_endpoint{get_shm_endpoint("patient_second")};
+    NoPresenter presenter{};
+
+    ShmTransport first{first_endpoint, second_endpoint, &presenter};
+    ShmTransport second{second_endpoint, first_endpoint, &presenter};
+    second.set_delivery_waittime(2000);
+    atomic<size_t> number_of_received_messages{0};
+    first.start([](const Message&){});
+    // the first Message is held as long as a Worker might take for it
+    second.start([&](const Message&){
+        if (number_of_received_messages++ == 0) {
+            this_thread::sleep_for(chrono::milliseconds(1500));
+        }
+    });
+
+    first.send(Message::start_election());
+    REQUIRE(wait_until([&](){ return number_of_received_messages == 1; }, chrono::seconds(5)));
+    first.send(Message::start_election());
+
+    CHECK(wait_until([&](){ return number_of_received_messages == 2; }, chrono::seconds(5)));
+    CHECK_FALSE(first.has_lost_next());
+
+    first.stop();
+    second.stop();
+}
+
+TEST_CASE(
+    "Rings as segments linked by ShmTransports elect the Worker with the highest id", 
+    "[shm_transport]"
+) {
+    string first_endpoint{get_shm_endpoint("first_segment")};
+    string second_endpoint{get_shm_endpoint("second_segment")};
+    // shared by both segments, only the leader's segment finishes the election
+    SegmentRecorder recorder{};
+
+    Ring first_segment(5, 0, &recorder, {}, {}, SetupOptions{7, 0, 0, 12});
+    Ring second_segment(7, 0, &recorder, {}, {}, SetupOptions{7, 0, 5, 12});
+    first_segment.connect(make_unique<ShmTransport>(first_endpoint, second_endpoint, &recorder));
+    second_segment.connect(make_unique<ShmTransport>(second_endpoint, first_endpoint, &recorder));
+
+    first_segment.start();
+    second_segment.start();
+    first_segment.start_election();
+
+    wait_until([&](){ return recorder.election_finished.load(); }, chrono::seconds(5));
+
+    first_segment.stop();
+    second_segment.stop();
+
+    REQUIRE(recorder.election_finished);
+    CHECK(recorder.leader_id == recorder.highest_id);
+}
+
+TEST_CASE(
+    "A segment removes the next segment it lost like a dead neighbour and elects on its own", 
+    "[shm_transport]"
+) {
+    string first_endpoint{get_shm_endpoint("lost_first_segment")};
+    string second_endpoint{get_shm_endpoint("lost_second_segment")};
+    DeadNeighbourRecorder first_recorder{};
+    SegmentRecorder second_recorder{};
+
+    Ring first_segment(5, 0, &first_recorder, {}, {}, SetupOptions{7, 0, 0, 12});
+    Ring second_segment(7, 0, &second_recorder, {}, {}, SetupOptions{7, 0, 5, 12});
+    first_segment.connect(make_unique<ShmTransport>(first_endpoint, second_endpoint, &first_recorder));
+    second_segment.connect(make_unique<ShmTransport>(second_endpoint, first_endpoint, &second_recorder));
+
+    first_segment.start();
+    second_segment.start();
+    this_thread::sleep_for(chrono::milliseconds(300));
+    second_segment.stop();
+    // the next segment is checked every 100 ms
+    this_thread::sleep_for(chrono::milliseconds(300));
+
+    first_segment.start_election();
+    wait_until([&](){ return first_recorder.election_finished.load(); }, chrono::seconds(5));
+
+    first_segment.stop();
+
+    REQUIRE(first_recorder.election_finished);
+    CHECK(first_recorder.leader_id == first_recorder.highest_id);
+    CHECK(first_recorder.number_of_dead_neighbours == 1);
+}
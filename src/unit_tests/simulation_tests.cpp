@@ -0,0 +1,195 @@
+#include "simulation.h"
+#include "presenters/no_presenter.h"
+
+#include "catch2/catch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace std;
+
+
+// A Presenter which records the ids of the created Workers
+class IdRecorder: public NoPresenter {
+  public:
+    vector<unsigned int> ids{};
+
+    void worker_created(unsigned int worker_id, unsigned int) override {
+        ids.push_back(worker_id);
+    }
+};
+
+TEST_CASE(
+    "Simulation elects the Worker with the highest id on a virtual clock",
+    "[simulation]"
+) {
+    size_t size{GENERATE(1, 7, 1000)};
+    unsigned int worker_sleeptime{GENERATE(0u, 500u)};
+    IdRecorder recorder{};
+
+    Simulation simulation(
+        size,
+        worker_sleeptime,
+        &recorder,
+        SimulationOptions{42, 100, 0}
+    );
+    SimulatedElection election{simulation.simulate_election()};
+
+    REQUIRE(election.is_finished);
+    CHECK(election.leader_id == *max_element(recorder.ids.begin(), recorder.ids.end()));
+
+    SECTION("the Elected Message passes every Worker once") {
+        CHECK(election.number_of_elected_messages == size);
+    }
+
+    SECTION("a single initiator has only one Message on its way at a time") {
+        // the initiator takes the start after its sleep
+        // and then every Message takes one hop and one sleep
+        VirtualTime hops{
+            election.number_of_proposals + election.number_of_elected_messages
+        };
+        CHECK(
+            election.latency
+                ==
+            worker_sleeptime * 1000 + hops * (100 + worker_sleeptime * 1000)
+        );
+    }
+
+    SECTION("a following election elects the same leader again") {
+        SimulatedElection next_election{simulation.simulate_election()};
+
+        REQUIRE(next_election.is_finished);
+        CHECK(next_election.leader_id == election.leader_id);
+    }
+}
+
+TEST_CASE(
+    "Simulation is reproducible from its seed",
+    "[simulation]"
+) {
+    auto simulate{[](uint64_t seed, IdRecorder& recorder) {
+        Simulation simulation(500, 10, &recorder, SimulationOptions{seed, 100, 50});
+        return simulation.simulate_election();
+    }};
+
+    IdRecorder recorder{};
+    IdRecorder same_seed_recorder{};
+    IdRecorder other_seed_recorder{};
+    SimulatedElection election{simulate(7, recorder)};
+    SimulatedElection same_seed_election{simulate(7, same_seed_recorder)};
+    simulate(8, other_seed_recorder);
+
+    SECTION("the same seed results in the same ids and the same election") {
+        CHECK(recorder.ids == same_seed_recorder.ids);
+        CHECK(election.leader_id == same_seed_election.leader_id);
+        CHECK(election.number_of_proposals == same_seed_election.number_of_proposals);
+        CHECK(election.latency == same_seed_election.latency);
+    }
+
+    SECTION("another seed results in other ids") {
+        CHECK(recorder.ids != other_seed_recorder.ids);
+    }
+}
+
+TEST_CASE(
+    "Simulation elects the Worker with the highest id with Hirschberg and Sinclair",
+    "[simulation]"
+) {
+    size_t size{GENERATE(1, 2, 7, 1000)};
+    IdRecorder recorder{};
+
+    Simulation simulation(
+        size,
+        10,
+        &recorder,
+        SimulationOptions{42, 100, 50, ElectionAlgorithm::hirschberg_sinclair}
+    );
+    SimulatedElection election{simulation.simulate_election()};
+
+    REQUIRE(election.is_finished);
+    CHECK(election.leader_id == *max_element(recorder.ids.begin(), recorder.ids.end()));
+    CHECK(election.number_of_elected_messages == size);
+
+    SECTION("the probes and replies stay within O(n log n)") {
+        // each phase takes at most 4 Messages per Worker, once probing and once replying
+        // in both directions, and there are at most ceil(log2(n)) + 1 phases
+        size_t number_of_phases{(size_t)ceil(log2((double)size)) + 1};
+        CHECK(election.number_of_proposals <= 4 * size * number_of_phases);
+    }
+
+    SECTION("a following election elects the same leader again") {
+        SimulatedElection next_election{simulation.simulate_election()};
+
+        REQUIRE(next_election.is_finished);
+        CHECK(next_election.leader_id == election.leader_id);
+    }
+}
+
+TEST_CASE(
+    "Simulation elects the Worker with the highest id with Peterson",
+    "[simulation]"
+) {
+    size_t size{GENERATE(1, 2, 7, 1000)};
+    IdRecorder recorder{};
+
+    Simulation simulation(
+        size,
+        10,
+        &recorder,
+        SimulationOptions{42, 100, 50, ElectionAlgorithm::peterson}
+    );
+    SimulatedElection election{simulation.simulate_election()};
+
+    REQUIRE(election.is_finished);
+    CHECK(election.leader_id == *max_element(recorder.ids.begin(), recorder.ids.end()));
+    CHECK(election.number_of_elected_messages == size);
+
+    SECTION("the candidates stay within O(n log n)") {
+        // each phase takes 2 Messages per Worker, at least half of the active Workers
+        // become relays per phase, and the last candidate is proposed to its Worker
+        size_t number_of_phases{(size_t)ceil(log2((double)size)) + 1};
+        CHECK(election.number_of_proposals <= 2 * size * number_of_phases + size);
+    }
+
+    SECTION("a following election elects the same leader again") {
+        SimulatedElection next_election{simulation.simulate_election()};
+
+        REQUIRE(next_election.is_finished);
+        CHECK(next_election.leader_id == election.leader_id);
+    }
+}
+
+TEST_CASE(
+    "Simulation bounds the proposals of Chang and Roberts with the id layouts",
+    "[simulation]"
+) {
+    size_t size{100};
+    IdRecorder recorder{};
+
+    SECTION("the highest id first and one initiator only needs one round") {
+        Simulation simulation(size, 10, &recorder, SimulationOptions{
+            42, 100, 50, ElectionAlgorithm::chang_roberts, IdLayout::descending, 1
+        });
+
+        CHECK(simulation.simulate_election().number_of_proposals == size);
+    }
+
+    SECTION("ascending ids let every Worker propose itself once") {
+        Simulation simulation(size, 10, &recorder, SimulationOptions{
+            42, 100, 50, ElectionAlgorithm::chang_roberts, IdLayout::ascending, 1
+        });
+
+        CHECK(simulation.simulate_election().number_of_proposals == 2 * size - 1);
+    }
+
+    SECTION("the adversarial ids with all initiators are the worst case") {
+        Simulation simulation(size, 10, &recorder, SimulationOptions{
+            42, 100, 50, ElectionAlgorithm::chang_roberts, IdLayout::adversarial, 0
+        });
+        SimulatedElection election{simulation.simulate_election()};
+
+        REQUIRE(election.is_finished);
+        CHECK(election.leader_id == *max_element(recorder.ids.begin(), recorder.ids.end()));
+        CHECK(election.number_of_proposals == size * (size - 1) / 2 + size);
+    }
+}
@@ -0,0 +1,71 @@
+#include "sized_thread.h"
+
+#include "catch2/catch.hpp"
+#include <atomic>
+#include <utility>
+
+using namespace std;
+
+
+TEST_CASE("SizedThread runs its function until it's joined", "[sized_thread]") {
+    atomic<bool> has_run{false};
+
+    SizedThread thread{0, [&has_run](){ has_run = true; }};
+    REQUIRE(thread.joinable());
+
+    SECTION("in its own handle") {
+        thread.join();
+    }
+
+    SECTION("after being moved to another handle") {
+        SizedThread moved_thread{move(thread)};
+        CHECK_FALSE(thread.joinable());
+        REQUIRE(moved_thread.joinable());
+
+        moved_thread.join();
+    }
+
+    CHECK(has_run);
+}
+
+TEST_CASE("SizedThread only tells stack sizes which can be used", "[sized_thread]") {
+    CHECK(SizedThread::can_use_stack_size(0));
+    CHECK(SizedThread::can_use_stack_size(1024 * 1024));
+    CHECK_FALSE(SizedThread::can_use_stack_size(1));
+}
+
+#ifdef __GLIBC__
+
+static size_t get_default_stack_size() {
+    size_t stack_size{0};
+    pthread_attr_t attributes;
+    if (pthread_getattr_default_np(&attributes) == 0) {
+        pthread_attr_getstacksize(&attributes, &stack_size);
+        pthread_attr_destroy(&attributes);
+    }
+
+    return stack_size;
+}
+
+TEST_CASE(
+    "SizedThread has its own stack size and leaves the default of the process",
+    "[sized_thread]"
+) {
+    size_t default_stack_size{get_default_stack_size()};
+    size_t stack_size{default_stack_size == 512 * 1024 ? size_t{256 * 1024} : size_t{512 * 1024}};
+    size_t thread_stack_size{0};
+
+    SizedThread thread{stack_size, [&thread_stack_size](){
+        pthread_attr_t attributes;
+        if (pthread_getattr_np(pthread_self(), &attributes) == 0) {
+            pthread_attr_getstacksize(&attributes, &thread_stack_size);
+            pthread_attr_destroy(&attributes);
+        }
+    }};
+    thread.join();
+
+    CHECK(thread_stack_size == stack_size);
+    CHECK(get_default_stack_size() == default_stack_size);
+}
+
+#endif
@@ -0,0 +1,192 @@
+#include "socket_transport.h"
+#include "ring.h"
+#include "presenters/no_presenter.h"
+#include "segment_recorder.h"
+
+#include "catch2/catch.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+
+// Unique socket paths per test process
+static string get_socket_path(const string& name) {
+    return "unix:/tmp/ring_voting_test_" + to_string(getpid()) + "_" + name;
+}
+
+// A loopback port per test process, below the ephemeral ports
+static string get_tcp_endpoint() {
+    return "tcp:127.0.0.1:" + to_string(10000 + getpid() % 20000);
+}
+
+TEST_CASE("SocketTransport parses Unix-domain and TCP endpoints", "[socket_transport]") {
+    CHECK_NOTHROW(SocketTransport::parse_endpoint("unix:/tmp/segment"));
+    CHECK_NOTHROW(SocketTransport::parse_endpoint("tcp:127.0.0.1:5000"));
+
+    CHECK_THROWS_AS(SocketTransport::parse_endpoint("unix:"), invalid_argument);
+    CHECK_THROWS_AS(SocketTransport::parse_endpoint("tcp:127.0.0.1"), invalid_argument);
+    CHECK_THROWS_AS(SocketTransport::parse_endpoint("tcp:localhost:port"), invalid_argument);
+    CHECK_THROWS_AS(SocketTransport::parse_endpoint("/tmp/segment"), invalid_argument);
+}
+
+TEST_CASE("SocketTransports deliver the Messages sent in their order", "[socket_transport]") {
+    string endpoint{GENERATE(as<string>{}, "unix", "tcp")};
+    endpoint = endpoint == "unix" ? get_socket_path("order") : get_tcp_endpoint();
+    NoPresenter presenter{};
+
+    // one Transport sends to itself
+    SocketTransport transport{endpoint, endpoint, &presenter};
+    vector<unsigned int> ids{};
+    atomic<size_t> number_of_received_messages{0};
+    transport.start([&](const Message& message) {
+        ids.push_back(message.id);
+        number_of_received_messages++;
+    });
+
+    for (unsigned int id{0}; id < 1000; id++) {
+        transport.send(Message::election_proposal(id));
+    }
+
+    wait_until([&](){ return number_of_received_messages == 1000; }, chrono::seconds(5));
+    transport.stop();
+
+    REQUIRE(ids.size() == 1000);
+    for (unsigned int id{0}; id < 1000; id++) {
+        CHECK(ids[id] == id);
+    }
+}
+
+TEST_CASE(
+    "A SocketTransport loses the next segment when it closes the connection and links to it again", 
+    "[socket_transport]"
+) {
+    string first_endpoint{get_socket_path("rejoin_first")};
+    string second_endpoint{get_socket_path("rejoin_second")};
+    NoPresenter presenter{};
+
+    SocketTransport first{first_endpoint, second_endpoint, &presenter};
+    first.start([](const Message&){});
+    {
+        SocketTransport second{second_endpoint, first_endpoint, &presenter};
+        atomic<bool> received{false};
+        second.start([&](const Message&){ received = true; });
+
+        first.send(Message::start_election());
+        REQUIRE(wait_until([&](){ return received.load(); }, chrono::seconds(5)));
+        CHECK_FALSE(first.has_lost_next());
+    }
+
+    REQUIRE(wait_until([&](){ return first.has_lost_next(); }, chrono::seconds(2)));
+    // the loss is taken once
+    vector<Message> unsent_messages{};
+    CHECK(first.take_lost_next(unsent_messages));
+    CHECK_FALSE(first.take_lost_next(unsent_messages));
+
+    SocketTransport restarted_second{second_endpoint, first_endpoint, &presenter};
+    atomic<bool> received{false};
+    restarted_second.start([&](const Message&){ received = true; });
+
+    REQUIRE(wait_until([&](){ return !first.has_lost_next(); }, chrono::seconds(2)));
+    first.send(Message::start_election());
+    CHECK(wait_until([&](){ return received.load(); }, chrono::seconds(5)));
+
+    first.stop();
+    restarted_second.stop();
+}
+
+TEST_CASE(
+    "A SocketTransport loses a next segment, which isn't there, once too much waits for it", 
+    "[socket_transport]"
+) {
+    NoPresenter presenter{};
+
+    // nothing listens on the next endpoint
+    SocketTransport transport{
+        get_socket_path("unreachable_first"), 
+        get_socket_path("unreachable_second"), 
+        &presenter
+    };
+    transport.start([](const Message&){});
+
+    // each of them takes up 64 KiB, 4 MiB may wait
+    for (unsigned int i{0}; i < 100; i++) {
+        transport.send(Message::log_message(string(64 * 1024, (char)('a' + i % 26))));
+    }
+
+    REQUIRE(wait_until([&](){ return transport.has_lost_next(); }, chrono::seconds(2)));
+    vector<Message> unsent_messages{};
+    REQUIRE(transport.take_lost_next(unsent_messages));
+    transport.stop();
+
+    // what's sent after the loss is dropped, what's before is kept in order
+    CHECK(unsent_messages.size() >= 64);
+    CHECK(unsent_messages.size() < 100);
+    for (size_t i{0}; i < unsent_messages.size(); i++) {
+        CHECK(unsent_messages[i].get_content() == string(64 * 1024, (char)('a' + i % 26)));
+        unsent_messages[i].dispose();
+    }
+}
+
+TEST_CASE(
+    "Rings as segments linked by SocketTransports elect the Worker with the highest id", 
+    "[socket_transport]"
+) {
+    string first_endpoint{get_socket_path("first")};
+    string second_endpoint{get_socket_path("second")};
+    // shared by both segments, only the leader's segment finishes the election
+    SegmentRecorder recorder{};
+
+    Ring first_segment(5, 0, &recorder, {}, {}, SetupOptions{7, 0, 0, 12});
+    Ring second_segment(7, 0, &recorder, {}, {}, SetupOptions{7, 0, 5, 12});
+    first_segment.connect(make_unique<SocketTransport>(first_endpoint, second_endpoint, &recorder));
+    second_segment.connect(make_unique<SocketTransport>(second_endpoint, first_endpoint, &recorder));
+
+    first_segment.start();
+    second_segment.start();
+    first_segment.start_election();
+
+    wait_until([&](){ return recorder.election_finished.load(); }, chrono::seconds(5));
+
+    first_segment.stop();
+    second_segment.stop();
+
+    REQUIRE(recorder.election_finished);
+    CHECK(recorder.leader_id == recorder.highest_id);
+}
+
+TEST_CASE(
+    "A segment removes the next segment it lost over a socket like a dead neighbour", 
+    "[socket_transport]"
+) {
+    string first_endpoint{get_socket_path("lost_first_segment")};
+    string second_endpoint{get_socket_path("lost_second_segment")};
+    DeadNeighbourRecorder first_recorder{};
+    SegmentRecorder second_recorder{};
+
+    Ring first_segment(5, 0, &first_recorder, {}, {}, SetupOptions{7, 0, 0, 12});
+    Ring second_segment(7, 0, &second_recorder, {}, {}, SetupOptions{7, 0, 5, 12});
+    first_segment.connect(make_unique<SocketTransport>(first_endpoint, second_endpoint, &first_recorder));
+    second_segment.connect(make_unique<SocketTransport>(second_endpoint, first_endpoint, &second_recorder));
+
+    first_segment.start();
+    second_segment.start();
+    this_thread::sleep_for(chrono::milliseconds(300));
+    second_segment.stop();
+    this_thread::sleep_for(chrono::milliseconds(300));
+
+    first_segment.start_election();
+    wait_until([&](){ return first_recorder.election_finished.load(); }, chrono::seconds(5));
+
+    first_segment.stop();
+
+    REQUIRE(first_recorder.election_finished);
+    CHECK(first_recorder.leader_id == first_recorder.highest_id);
+    CHECK(first_recorder.number_of_dead_neighbours == 1);
+}
@@ -0,0 +1,65 @@
+#include "spsc_channel.h"
+
+#include "catch2/catch.hpp"
+#include <thread>
+
+using namespace std;
+
+
+TEST_CASE(
+    "SPSC Channel passes values from one thread to another in their order",
+    "[spsc_channel]"
+) {
+    SECTION("the capacity is rounded up to a power of 2") {
+        SpscChannel<unsigned int> channel{5};
+
+        CHECK(channel.get_capacity() == 8);
+    }
+
+    SECTION("a full Channel refuses values and an empty one has none") {
+        SpscChannel<unsigned int> channel{4};
+        unsigned int value{0};
+
+        CHECK(channel.is_empty());
+        CHECK_FALSE(channel.try_pop(value));
+
+        for (unsigned int i{0}; i < 4; i++) {
+            CHECK(channel.try_push(i));
+        }
+        CHECK_FALSE(channel.try_push(4));
+
+        CHECK(channel.try_pop(value));
+        CHECK(value == 0);
+        CHECK(channel.try_push(4));
+    }
+
+    SECTION("the values arrive in order and completely between threads") {
+        SpscChannel<unsigned int> channel{16};
+        const unsigned int number_of_values{100000};
+
+        thread producer{[&channel, number_of_values](){
+            for (unsigned int i{0}; i < number_of_values; i++) {
+                while (!channel.try_push(i)) {
+                    this_thread::yield();
+                }
+            }
+        }};
+
+        unsigned int expected_value{0};
+        bool is_in_order{true};
+        while (expected_value < number_of_values) {
+            unsigned int value{0};
+            if (channel.try_pop(value)) {
+                is_in_order = is_in_order && value == expected_value;
+                expected_value++;
+            }
+            else {
+                this_thread::yield();
+            }
+        }
+        producer.join();
+
+        CHECK(is_in_order);
+        CHECK(channel.is_empty());
+    }
+}
@@ -0,0 +1,151 @@
+#include "timing_wheel.h"
+
+#include "catch2/catch.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+TEST_CASE(
+    "Timing Wheel calls the callbacks of Timers when they expire", 
+    "[timing_wheel]"
+) {
+    TimingWheel& wheel{TimingWheel::get_instance()};
+    auto start{chrono::steady_clock::now()};
+
+    SECTION("a Timer expires not before its deadline") {
+        unsigned int delay{GENERATE(5u, 70u, 300u)}; // ms, on different levels
+        atomic<bool> expired{false};
+        chrono::steady_clock::time_point expiry_time{};
+
+        wheel.schedule(
+            start + chrono::milliseconds(delay), 
+            [&](){
+                expiry_time = chrono::steady_clock::now();
+                expired = true;
+            }
+        );
+
+        while (!expired) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+
+        CHECK(expiry_time - start >= chrono::milliseconds(delay));
+        CHECK(expiry_time - start < chrono::milliseconds(delay + 50));
+    }
+
+    SECTION("Timers expire in the order of their deadlines") {
+        mutex order_mtx;
+        vector<unsigned int> order{};
+        atomic<unsigned int> number_expired{0};
+
+        for (unsigned int delay : {90u, 10u, 140u, 40u, 70u}) {
+            wheel.schedule(
+                start + chrono::milliseconds(delay), 
+                [&, delay](){
+                    lock_guard<mutex> order_lck{order_mtx};
+                    order.push_back(delay);
+                    number_expired++;
+                }
+            );
+        }
+
+        while (number_expired < 5) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+
+        CHECK(order == vector<unsigned int>{10, 40, 70, 90, 140});
+    }
+
+    SECTION("a cancelled Timer doesn't expire") {
+        atomic<bool> cancelled_expired{false};
+        atomic<bool> other_expired{false};
+
+        auto handle{
+            wheel.schedule(
+                start + chrono::milliseconds(20), 
+                [&](){ cancelled_expired = true; }
+            )
+        };
+        wheel.schedule(
+            start + chrono::milliseconds(40), 
+            [&](){ other_expired = true; }
+        );
+
+        CHECK(wheel.cancel(handle));
+
+        while (!other_expired) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+
+        CHECK_FALSE(cancelled_expired);
+        CHECK_FALSE(wheel.cancel(handle));
+    }
+
+    SECTION("an expired Timer can't be cancelled") {
+        atomic<bool> expired{false};
+
+        auto handle{
+            wheel.schedule(
+                start + chrono::milliseconds(5), 
+                [&](){ expired = true; }
+            )
+        };
+
+        while (!expired) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+
+        CHECK_FALSE(wheel.cancel(handle));
+    }
+}
+
+TEST_CASE(
+    "Timing Wheel cascades a Timer beyond the span of its highest level", 
+    "[timing_wheel]"
+) {
+    // a wheel of its own, which is moved on by hand,
+    // since its highest level is only reached after hours
+    TimingWheel wheel{};
+    const uint64_t level_4_span{uint64_t{1} << (TimingWheel::slot_bits * 4)};
+    const uint64_t wheel_span{level_4_span * TimingWheel::slots_per_level};
+    atomic<bool> expired{false};
+
+    // expires in the 3rd slot of the highest level, one wheel span later
+    auto handle{
+        wheel.schedule(
+            wheel.start_time + chrono::milliseconds(wheel_span + 2 * level_4_span), 
+            [&](){ expired = true; }
+        )
+    };
+
+    {
+        lock_guard<mutex> wheel_lck{wheel.wheel_mtx};
+        TimingWheel::Slot expired_timers{};
+
+        // reaching its slot the first time, the Timer is still too far ahead
+        wheel.current_tick = 2 * level_4_span - 1;
+        wheel.advance(expired_timers);
+        CHECK(expired_timers.is_empty());
+
+        // reaching it the second time, it's cascaded down and expires after it
+        wheel.current_tick = wheel_span + 2 * level_4_span - 1;
+        wheel.advance(expired_timers);
+        CHECK(expired_timers.is_empty());
+        wheel.advance(expired_timers);
+
+        REQUIRE_FALSE(expired_timers.is_empty());
+        CHECK(expired_timers.head.next == handle.timer);
+        CHECK(expired_timers.head.next->next == &expired_timers.head);
+
+        wheel.unlink(handle.timer);
+        wheel.recycle(handle.timer);
+    }
+
+    CHECK_FALSE(expired);
+    CHECK_FALSE(wheel.cancel(handle));
+}
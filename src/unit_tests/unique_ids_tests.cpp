@@ -0,0 +1,114 @@
+#include "unique_ids.h"
+
+#include "catch2/catch.hpp"
+#include <algorithm>
+#include <functional>
+#include <set>
+#include <vector>
+
+using namespace std;
+
+
+TEST_CASE(
+    "get_unique_ids returns the request amount of unique and random ids",
+    "[get_unique_ids]"
+) {
+    size_t size{GENERATE(5, 12, 21, 100, 50000)};
+    auto ids{get_unique_ids(size, 42)};
+
+    REQUIRE(ids.size() == size);
+
+    SECTION("there are no duplicate ids and they are randomized") {
+        set<unsigned int> unique_ids{ids.begin(), ids.end()};
+
+        REQUIRE(unique_ids.size() == size);
+        CHECK_FALSE(is_sorted(ids.begin(), ids.end()));
+
+        SECTION("the ids are not always the same") {
+            vector<unsigned int> other_ids{get_unique_ids(size, 43)};
+            unique_ids.insert(other_ids.begin(), other_ids.end());
+
+            CHECK(unique_ids.size() > size);
+        }
+    }
+
+    SECTION("the ids are within their range") {
+        unsigned int max_id{size < 100 ? 999 : (unsigned int)size * 10};
+
+        CHECK(*max_element(ids.begin(), ids.end()) <= max_id);
+    }
+
+    SECTION("the same seed results in the same ids") {
+        CHECK(get_unique_ids(size, 42) == ids);
+    }
+}
+
+TEST_CASE("get_unique_ids returns no ids for no ids requested", "[get_unique_ids]") {
+    CHECK(get_unique_ids(0, 42).empty());
+}
+
+TEST_CASE("get_unique_ids lays out the same ids along the ring", "[get_unique_ids]") {
+    size_t size{GENERATE(1, 12, 1000)};
+    auto random_ids{get_unique_ids(size, 42)};
+    multiset<unsigned int> random_id_set{random_ids.begin(), random_ids.end()};
+
+    CHECK(get_unique_ids(size, 42, IdLayout::random) == random_ids);
+
+    SECTION("ascending") {
+        auto ids{get_unique_ids(size, 42, IdLayout::ascending)};
+
+        CHECK(multiset<unsigned int>{ids.begin(), ids.end()} == random_id_set);
+        CHECK(is_sorted(ids.begin(), ids.end()));
+    }
+
+    SECTION("descending") {
+        auto ids{get_unique_ids(size, 42, IdLayout::descending)};
+
+        CHECK(multiset<unsigned int>{ids.begin(), ids.end()} == random_id_set);
+        CHECK(is_sorted(ids.rbegin(), ids.rend()));
+    }
+
+    SECTION("adversarial") {
+        size_t number_of_initiators{GENERATE(0, 1, 4)};
+        auto ids{get_unique_ids(size, 42, IdLayout::adversarial, number_of_initiators)};
+
+        CHECK(multiset<unsigned int>{ids.begin(), ids.end()} == random_id_set);
+        CHECK(ids.back() == *max_element(ids.begin(), ids.end()));
+
+        // the initiators hold the next highest ids, decreasing along the ring
+        auto initiators{get_initiator_positions(size, number_of_initiators)};
+        vector<unsigned int> sorted_ids{ids};
+        sort(sorted_ids.begin(), sorted_ids.end(), greater<unsigned int>());
+        size_t next_id{1};
+        for (size_t position : initiators) {
+            if (position != size - 1) {
+                CHECK(ids[position] == sorted_ids[next_id++]);
+            }
+        }
+    }
+}
+
+TEST_CASE(
+    "get_initiator_positions spreads the initiators evenly from the first position", 
+    "[get_unique_ids]"
+) {
+    CHECK(get_initiator_positions(10, 1) == vector<size_t>{0});
+    CHECK(get_initiator_positions(10, 4) == vector<size_t>{0, 2, 5, 7});
+    CHECK(get_initiator_positions(3, 0) == vector<size_t>{0, 1, 2});
+    CHECK(get_initiator_positions(3, 5) == vector<size_t>{0, 1, 2});
+    CHECK(get_initiator_positions(0, 1).empty());
+}
+
+TEST_CASE("IdLayout is parsed from its name", "[get_unique_ids]") {
+    IdLayout id_layout{GENERATE(
+        IdLayout::random, 
+        IdLayout::ascending, 
+        IdLayout::descending, 
+        IdLayout::adversarial
+    )};
+    IdLayout parsed_id_layout{};
+
+    REQUIRE(id_layout_from_string(to_string(id_layout), parsed_id_layout));
+    CHECK(parsed_id_layout == id_layout);
+    CHECK_FALSE(id_layout_from_string("sorted", parsed_id_layout));
+}
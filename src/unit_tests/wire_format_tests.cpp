@@ -0,0 +1,118 @@
+#include "wire_format.h"
+
+#include "catch2/catch.hpp"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+
+TEST_CASE("Messages are the same after being encoded and decoded", "[wire_format]") {
+    Message message{GENERATE(
+        Message::no_message(),
+        Message::stop(),
+        Message::start_election(),
+        Message::start_election(65535),
+        Message::election_proposal(4000000000u),
+        Message::elected(17),
+        Message::dead_worker(3)
+    )};
+    vector<uint8_t> bytes{};
+
+    REQUIRE(encode_message(message, bytes));
+
+    Message decoded_message{};
+    CHECK(decode_message(bytes.data(), bytes.size(), decoded_message) == bytes.size());
+    CHECK(decoded_message.type == message.type);
+    CHECK(decoded_message.id == message.id);
+    CHECK(decoded_message.epoch == message.epoch);
+
+    SECTION("an incomplete Message isn't decoded") {
+        CHECK(decode_message(bytes.data(), bytes.size() - 1, decoded_message) == 0);
+    }
+}
+
+TEST_CASE("The Messages of an election are encoded with its epoch", "[wire_format]") {
+    Message message{GENERATE(Message::election_proposal(12), Message::elected(12))};
+    message.epoch = 513;
+    vector<uint8_t> bytes{};
+
+    REQUIRE(encode_message(message, bytes));
+
+    Message decoded_message{};
+    REQUIRE(decode_message(bytes.data(), bytes.size(), decoded_message) == bytes.size());
+    CHECK(decoded_message.id == 12);
+    CHECK(decoded_message.epoch == 513);
+}
+
+TEST_CASE("A log message is encoded with its content", "[wire_format]") {
+    Message message{Message::log_message("hello segment")};
+    vector<uint8_t> bytes{};
+
+    REQUIRE(encode_message(message, bytes));
+    message.dispose();
+
+    Message decoded_message{};
+    REQUIRE(decode_message(bytes.data(), bytes.size(), decoded_message) == bytes.size());
+    CHECK(decoded_message.type == MessageType::LogMessage);
+    CHECK(decoded_message.get_content() == "hello segment");
+    decoded_message.dispose();
+
+    CHECK(decode_message(bytes.data(), bytes.size() - 1, decoded_message) == 0);
+}
+
+TEST_CASE("A log message longer than 64 KiB is neither encoded nor decoded", "[wire_format]") {
+    Message message{Message::log_message(string(64 * 1024 + 1, 'x'))};
+    vector<uint8_t> bytes{};
+
+    CHECK_FALSE(encode_message(message, bytes));
+    CHECK(bytes.empty());
+    message.dispose();
+
+    // the length prefix alone of a corrupt peer
+    bytes = {(uint8_t)MessageType::LogMessage, 0xff, 0xff, 0xff, 0xff};
+    Message decoded_message{};
+    CHECK_THROWS_AS(decode_message(bytes.data(), bytes.size(), decoded_message), invalid_argument);
+}
+
+TEST_CASE("Consecutive Messages are decoded one after another", "[wire_format]") {
+    vector<uint8_t> bytes{};
+    encode_message(Message::election_proposal(5), bytes);
+    encode_message(Message::stop(), bytes);
+    encode_message(Message::elected(5), bytes);
+
+    vector<MessageType> types{};
+    size_t offset{0};
+    Message message{};
+    while (size_t number_of_bytes{decode_message(bytes.data() + offset, bytes.size() - offset, message)}) {
+        offset += number_of_bytes;
+        types.push_back(message.type);
+    }
+
+    CHECK(offset == bytes.size());
+    CHECK(types == vector<MessageType>{
+        MessageType::ElectionProposal, MessageType::Stop, MessageType::Elected
+    });
+}
+
+TEST_CASE("The Messages of Hirschberg and Sinclair and of Peterson can't be encoded", "[wire_format]") {
+    vector<uint8_t> bytes{};
+
+    CHECK_FALSE(encode_message(Message::probe(7, 1, 2, true), bytes));
+    CHECK_FALSE(encode_message(Message::reply(7, 1, false), bytes));
+    CHECK_FALSE(encode_message(Message::candidate(7, 1), bytes));
+    CHECK_FALSE(encode_message(Message::previous_candidate(7, 1), bytes));
+    CHECK(bytes.empty());
+}
+
+TEST_CASE("A new worker can't be encoded and unknown types can't be decoded", "[wire_format]") {
+    vector<uint8_t> bytes{};
+
+    CHECK_FALSE(encode_message(Message::new_worker(1, nullptr), bytes));
+    CHECK(bytes.empty());
+
+    bytes.push_back(200);
+    Message message{};
+    CHECK_THROWS_AS(decode_message(bytes.data(), bytes.size(), message), invalid_argument);
+}
@@ -2,6 +2,8 @@
 #include "worker.h"
 
 #include "catch2/catch.hpp"
+#include <memory>
+#include <set>
 #include <tuple>
 #include <cmath>
 #include <thread>
@@ -23,9 +25,11 @@ TEST_CASE(
     unsigned int dummy_id{get<0>(ids)};
     unsigned int worker_id{get<1>(ids)};
 
-    Worker dummy_worker(dummy_id, 0, 0, nullptr);
+    Worker dummy_worker(dummy_id, 1, 0, nullptr);
     Worker worker(worker_id, 0, 0, nullptr);
-    worker.set_neighbours({&dummy_worker});
+    worker.set_membership(
+        make_shared<SharedMembership>(vector<Worker*>{&worker, &dummy_worker})
+    );
 
     thread worker_thread{ref(worker)};
     sleep();
@@ -34,105 +38,130 @@ TEST_CASE(
     REQUIRE(worker.is_running());
     
     SECTION("Worker is able to start election") {
-        worker.assign_message_and_wait(new StartElection());
+        worker.assign_message_and_wait(Message::start_election());
         sleep();
 
-        CHECK(worker.participates_in_election);
+        CHECK(worker.election.participates_in_election);
         REQUIRE_FALSE(dummy_worker.message_buffer.is_empty());
 
         auto message{dummy_worker.message_buffer.take()};
-        REQUIRE(message->type == MessageType::ElectionProposal);
-        CHECK(message->cast_to<ElectionProposal>()->id == worker_id);
-
-        delete message;
+        REQUIRE(message.type == MessageType::ElectionProposal);
+        CHECK(message.id == worker_id);
     }
 
     SECTION("Worker is able to participate in election") {
-        worker.participates_in_election = false;
-        worker.is_leader = GENERATE(true, false);
+        worker.election.participates_in_election = false;
+        worker.election.is_leader = GENERATE(true, false);
 
-        worker.assign_message_and_wait(new ElectionProposal(dummy_id));
+        worker.assign_message_and_wait(Message::election_proposal(dummy_id));
         sleep();
 
-        CHECK(worker.participates_in_election);
-        CHECK_FALSE(worker.is_leader);
+        CHECK(worker.election.participates_in_election);
+        CHECK_FALSE(worker.election.is_leader);
         REQUIRE_FALSE(dummy_worker.message_buffer.is_empty());
 
         auto message{dummy_worker.message_buffer.take()};
-        REQUIRE(message->type == MessageType::ElectionProposal);
-        CHECK(message->cast_to<ElectionProposal>()->id == max(worker_id, dummy_id));
-
-        delete message;
+        REQUIRE(message.type == MessageType::ElectionProposal);
+        CHECK(message.id == max(worker_id, dummy_id));
     }
 
     SECTION("Worker can handle out of order election proposals") {
-        worker.participates_in_election = true;
+        worker.election.participates_in_election = true;
 
-        worker.assign_message_and_wait(new ElectionProposal(dummy_id));
+        worker.assign_message_and_wait(Message::election_proposal(dummy_id));
         sleep();
 
-        CHECK(worker.participates_in_election);
+        CHECK(worker.election.participates_in_election);
         REQUIRE(dummy_worker.message_buffer.is_empty() == (dummy_id < worker_id));
 
         if (dummy_id > worker_id) {
             auto message{dummy_worker.message_buffer.take()};
-            REQUIRE(message->type == MessageType::ElectionProposal);
-            CHECK(message->cast_to<ElectionProposal>()->id == dummy_id);
-
-            delete message;
+            REQUIRE(message.type == MessageType::ElectionProposal);
+            CHECK(message.id == dummy_id);
         }
     }
 
     SECTION("Worker can be elected") {
-        worker.participates_in_election = true;
-        worker.is_leader = false;
+        worker.election.participates_in_election = true;
+        worker.election.is_leader = false;
 
-        worker.assign_message_and_wait(new ElectionProposal(worker_id));
+        worker.assign_message_and_wait(Message::election_proposal(worker_id));
         sleep();
 
-        CHECK_FALSE(worker.participates_in_election);
-        CHECK(worker.is_leader);
+        CHECK_FALSE(worker.election.participates_in_election);
+        CHECK(worker.election.is_leader);
         REQUIRE_FALSE(dummy_worker.message_buffer.is_empty());
 
         auto message{dummy_worker.message_buffer.take()};
-        REQUIRE(message->type == MessageType::Elected);
-        CHECK(message->cast_to<Elected>()->id == worker_id);
-
-        delete message;
+        REQUIRE(message.type == MessageType::Elected);
+        CHECK(message.id == worker_id);
     }
 
     SECTION("Worker acts accordingly when someone is elected") {
-        worker.participates_in_election = true;
-        worker.is_leader = false;
+        worker.election.participates_in_election = true;
+        worker.election.is_leader = false;
 
-        worker.assign_message_and_wait(new Elected(dummy_id));
+        worker.assign_message_and_wait(Message::elected(dummy_id));
         sleep();
 
-        CHECK_FALSE(worker.participates_in_election);
-        CHECK_FALSE(worker.is_leader);
+        CHECK_FALSE(worker.election.participates_in_election);
+        CHECK_FALSE(worker.election.is_leader);
         REQUIRE_FALSE(dummy_worker.message_buffer.is_empty());
 
         auto message{dummy_worker.message_buffer.take()};
-        REQUIRE(message->type == MessageType::Elected);
-        CHECK(message->cast_to<Elected>()->id == dummy_id);
+        REQUIRE(message.type == MessageType::Elected);
+        CHECK(message.id == dummy_id);
+    }
+
+    SECTION("Worker drops the Messages of an older election") {
+        worker.election.epoch = 5;
+        worker.election.participates_in_election = false;
+
+        Message proposal{Message::election_proposal(dummy_id)};
+        proposal.epoch = 4;
+        worker.assign_message_and_wait(proposal);
+        sleep();
 
-        delete message;
+        CHECK_FALSE(worker.election.participates_in_election);
+        CHECK(worker.election.epoch == 5);
+        CHECK(dummy_worker.message_buffer.is_empty());
+    }
+
+    SECTION("A Message of a newer election abandons the current one") {
+        worker.election.epoch = 65535;
+        worker.election.participates_in_election = true;
+
+        // the epochs wrap around
+        Message proposal{Message::election_proposal(dummy_id)};
+        proposal.epoch = 0;
+        worker.assign_message_and_wait(proposal);
+        sleep();
+
+        CHECK(worker.election.participates_in_election);
+        CHECK(worker.election.epoch == 0);
+        REQUIRE_FALSE(dummy_worker.message_buffer.is_empty());
+
+        // the Worker proposes itself anew, if its id is higher
+        auto message{dummy_worker.message_buffer.take()};
+        REQUIRE(message.type == MessageType::ElectionProposal);
+        CHECK(message.id == max(worker_id, dummy_id));
+        CHECK(message.epoch == 0);
     }
 
     SECTION("Worker is able to finish election") {
-        worker.participates_in_election = false;
-        worker.is_leader = true;
+        worker.election.participates_in_election = false;
+        worker.election.is_leader = true;
 
-        worker.assign_message_and_wait(new Elected(worker_id));
+        worker.assign_message_and_wait(Message::elected(worker_id));
         sleep();
 
-        CHECK_FALSE(worker.participates_in_election);
-        CHECK(worker.is_leader);
+        CHECK_FALSE(worker.election.participates_in_election);
+        CHECK(worker.election.is_leader);
 
         CHECK(dummy_worker.message_buffer.is_empty());
     }
 
-    worker.assign_message_and_wait(new Stop());
+    worker.assign_message_and_wait(Message::stop());
     sleep();
 
     REQUIRE_FALSE(dummy_worker.is_running());
@@ -148,12 +177,23 @@ TEST_CASE(
     unsigned int number_of_workers{GENERATE(12u, 15u)};
     unsigned int worker_position{GENERATE(0u, 1u, 4u, 11u)};
 
-    Worker dummy_worker(0, 0, 0, nullptr);
     Worker worker(0, worker_position, 0, nullptr);
-    
-    vector<Worker*> neighbours{};
-    neighbours.assign(number_of_workers, &dummy_worker);
-    worker.set_neighbours(move(neighbours));
+
+    // the other Workers of the Ring only receive
+    vector<unique_ptr<Worker>> other_workers{};
+    vector<Worker*> members{};
+    for (unsigned int i{0}; i < number_of_workers; i++) {
+        if (i == worker_position) {
+            members.push_back(&worker);
+        }
+        else {
+            other_workers.push_back(make_unique<Worker>(i + 1, i, 0, nullptr));
+            members.push_back(other_workers.back().get());
+        }
+    }
+    auto shared_membership{make_shared<SharedMembership>(members)};
+    worker.set_membership(shared_membership);
+    Worker& dummy_worker{*members[(worker_position + 1) % number_of_workers]};
 
     thread worker_thread{ref(worker)};
     sleep();
@@ -161,25 +201,25 @@ TEST_CASE(
     REQUIRE_FALSE(dummy_worker.is_running());
     REQUIRE(worker.is_running());
     
-    SECTION("Worker is able to remove dead neighbour") {
+    SECTION("Worker is able to pass on a dead neighbour removed by another worker") {
         unsigned int dead_worker_position{GENERATE(3u, 9u)};
         unsigned int expected_worker_position{worker.position};
         if (expected_worker_position > dead_worker_position) {
             expected_worker_position--;
         }
 
-        worker.assign_message_and_wait(new DeadWorker(dead_worker_position));
+        // the preceding worker of the dead worker removes it
+        shared_membership->remove(members[dead_worker_position]);
+        worker.assign_message_and_wait(Message::dead_worker(dead_worker_position));
         sleep();
 
-        CHECK(worker.neighbours.size() == number_of_workers - 1);
+        CHECK(worker.membership->size() == number_of_workers - 1);
         CHECK(worker.position == expected_worker_position);
         REQUIRE_FALSE(dummy_worker.message_buffer.is_empty());
 
         auto message{dummy_worker.message_buffer.take()};
-        REQUIRE(message->type == MessageType::DeadWorker);
-        CHECK(message->cast_to<DeadWorker>()->position == dead_worker_position);
-
-        delete message;
+        REQUIRE(message.type == MessageType::DeadWorker);
+        CHECK(message.position == dead_worker_position);
     }
 
     SECTION("Worker does not react on a dead Worker Message for its neighbour") {
@@ -188,43 +228,50 @@ TEST_CASE(
         };
         unsigned int expected_worker_position{worker.position};
 
-        worker.assign_message_and_wait(new DeadWorker(neighbour_position));
+        worker.assign_message_and_wait(Message::dead_worker(neighbour_position));
         sleep();
 
-        CHECK(worker.neighbours.size() == number_of_workers);
+        CHECK(worker.membership->size() == number_of_workers);
         CHECK(worker.position == expected_worker_position);
         CHECK(dummy_worker.message_buffer.is_empty());
     }
 
-    SECTION("Worker is able to add a new worker to its neighbours on correct index") {
-        Worker other_worker(1, 0, 0, nullptr);
+    SECTION("Worker is able to add a new worker to the membership on correct position") {
+        Worker other_worker(number_of_workers + 1, 0, 0, nullptr);
         unsigned int new_worker_position{GENERATE(3u, 9u)};
-        unsigned int expected_new_worker_index{
-            worker.get_neighbours_index_for_position(new_worker_position)
-        };
         unsigned int expected_worker_position{worker.position};
         if (expected_worker_position >= new_worker_position) {
             expected_worker_position++;
         }
 
         worker.assign_message_and_wait(
-            new NewWorker(new_worker_position, &other_worker)
+            Message::new_worker(new_worker_position, &other_worker)
         );
         sleep();
 
-        CHECK(worker.neighbours.size() == number_of_workers + 1);
-        CHECK(worker.neighbours[expected_new_worker_index]->id == other_worker.id);
+        CHECK(worker.membership->size() == number_of_workers + 1);
+        CHECK(worker.membership->at(new_worker_position)->election.id == other_worker.election.id);
         CHECK(worker.position == expected_worker_position);
+        CHECK(shared_membership->get_version() == 1);
         REQUIRE_FALSE(dummy_worker.message_buffer.is_empty());
 
         auto message{dummy_worker.message_buffer.take()};
-        REQUIRE(message->type == MessageType::NewWorker);
-        CHECK(message->cast_to<NewWorker>()->position == new_worker_position);
-
-        delete message;
+        REQUIRE(message.type == MessageType::NewWorker);
+        CHECK(message.position == new_worker_position);
+
+        SECTION("the new worker is only inserted once") {
+            worker.assign_message_and_wait(
+                Message::new_worker(new_worker_position, &other_worker)
+            );
+            sleep();
+
+            CHECK(worker.membership->size() == number_of_workers + 1);
+            CHECK(shared_membership->get_version() == 1);
+            dummy_worker.message_buffer.take();
+        }
     }
 
-    worker.assign_message_and_wait(new Stop());
+    worker.assign_message_and_wait(Message::stop());
     sleep();
 
     REQUIRE_FALSE(dummy_worker.is_running());
@@ -233,42 +280,317 @@ TEST_CASE(
     worker_thread.join();
 }
 
+TEST_CASE(
+    "Worker recognizes a dead neighbour by a delivery which timed out", 
+    "[worker][uses_message_buffer][worker_fault_tolerance]"
+) {
+    Worker worker(0, 0, 0, nullptr);
+    Worker dead_worker(1, 1, 0, nullptr);
+    Worker next_worker(2, 2, 0, nullptr);
+    worker.set_membership(make_shared<SharedMembership>(
+        vector<Worker*>{&worker, &dead_worker, &next_worker}
+    ));
+
+    thread worker_thread{ref(worker)};
+
+    worker.assign_message(Message::start_election());
+    sleep();
+    REQUIRE_FALSE(dead_worker.message_buffer.is_empty());
+
+    // the delivery times out after 1 s, the next message lets the worker notice
+    this_thread::sleep_for(chrono::milliseconds(1100));
+    worker.assign_message_and_wait(Message::no_message());
+    sleep();
+
+    CHECK(worker.membership->size() == 2);
+    CHECK(worker.get_direct_neighbour() == &next_worker);
+    REQUIRE_FALSE(next_worker.message_buffer.is_empty());
+
+    // the proposal assigned to the dead neighbour stays in its mailbox
+    // and isn't sent again, in case the neighbour is only slow
+    auto message{next_worker.message_buffer.take()};
+    REQUIRE(message.type == MessageType::DeadWorker);
+    CHECK(message.position == 1);
+    CHECK(next_worker.message_buffer.is_empty());
+
+    worker.assign_message_and_wait(Message::stop());
+    worker_thread.join();
+
+    auto proposal{dead_worker.message_buffer.take()};
+    CHECK(proposal.type == MessageType::ElectionProposal);
+}
+
+TEST_CASE(
+    "Worker is granted a delivery waittime for the wakeups its queued Messages take", 
+    "[worker]"
+) {
+    CHECK(Worker(1, 0, 100, nullptr).get_delivery_waittime() == 1000);
+    CHECK(Worker(1, 0, 1000, nullptr).get_delivery_waittime() == 2500);
+    // a full mailbox of 8 takes 8 wakeups one by one, but only 1 as one batch
+    CHECK(Worker(1, 0, 1000, nullptr, WorkerOptions{8, 1}).get_delivery_waittime() == 9500);
+    CHECK(Worker(1, 0, 1000, nullptr, WorkerOptions{8, 3}).get_delivery_waittime() == 4500);
+    CHECK(Worker(1, 0, 1000, nullptr, WorkerOptions{8, 8}).get_delivery_waittime() == 2500);
+    // a batch limit of 0 handles one Message per wakeup
+    CHECK(Worker(1, 0, 1000, nullptr, WorkerOptions{8, 0}).get_delivery_waittime() == 9500);
+}
+
+TEST_CASE(
+    "Worker handles all queued Messages per wakeup up to its batch limit", 
+    "[worker][uses_message_buffer][worker_batches]"
+) {
+    size_t batch_limit{GENERATE(1, 2, 8)};
+    unsigned int number_of_messages{5};
+
+    Worker dummy_worker(0, 1, 0, nullptr);
+    Worker worker(1, 0, 50, nullptr, WorkerOptions{8, batch_limit});
+    worker.set_membership(
+        make_shared<SharedMembership>(vector<Worker*>{&worker, &dummy_worker})
+    );
+
+    thread worker_thread{ref(worker)};
+
+    // all messages arrive before the worker wakes up the first time
+    for (unsigned int i{0}; i < number_of_messages; i++) {
+        worker.assign_message(Message::no_message());
+    }
+    worker.assign_message(Message::stop());
+    worker_thread.join();
+
+    auto& batch_statistics{worker.get_batch_statistics()};
+    CHECK(batch_statistics.number_of_messages == number_of_messages + 1);
+    CHECK(batch_statistics.largest_batch == min(batch_limit, (size_t)number_of_messages + 1));
+    CHECK(batch_statistics.number_of_batches == 
+        (number_of_messages + batch_limit) / batch_limit);
+}
+
 TEST_CASE(
     "Worker computation functions work as expected",
     "[worker][worker_computations]"
 ) {
-    unsigned int number_of_workers{12};
     unsigned int worker_position{3};
 
     Worker worker(0, worker_position, 0, nullptr);
-    
-    vector<Worker*> neighbours{};
-    neighbours.assign(number_of_workers, &worker);
-    worker.set_neighbours(move(neighbours));
-
-    SECTION("Worker is able to calculate the index for a neighbour position") {
-        tuple<unsigned int, unsigned int> pos_idx_pair{GENERATE(
-            tuple<unsigned int, unsigned int>{5, 1}, 
-            tuple<unsigned int, unsigned int>{2, 10},
-            tuple<unsigned int, unsigned int>{3, 11},
-            tuple<unsigned int, unsigned int>{0, 8},
-            tuple<unsigned int, unsigned int>{11, 7}
-        )}; 
-        unsigned int position{get<0>(pos_idx_pair)};
-        unsigned int index{get<1>(pos_idx_pair)};
-        
-        CHECK(worker.get_neighbours_index_for_position(position) == index);
-    }
 
     SECTION("Worker knows the position of its neighbour") {
         unsigned int number_of_workers{GENERATE(4u, 7u, 12u)};
 
-        vector<Worker*> neighbours{};
-        neighbours.assign(number_of_workers, &worker);
-        worker.set_neighbours(move(neighbours));
+        vector<unique_ptr<Worker>> other_workers{};
+        vector<Worker*> members{};
+        for (unsigned int i{0}; i < number_of_workers; i++) {
+            other_workers.push_back(make_unique<Worker>(i + 1, i, 0, nullptr));
+            members.push_back(
+                i == worker_position ? &worker : other_workers.back().get()
+            );
+        }
+        worker.set_membership(make_shared<SharedMembership>(members));
 
         CHECK(worker.get_direct_neighbour_position() == (worker_position + 1) % number_of_workers);
+        CHECK(worker.get_direct_neighbour() == members[(worker_position + 1) % number_of_workers]);
     }
+
+    SECTION("Worker follows the changes of the membership to its position") {
+        Worker first_worker(1, 0, 0, nullptr);
+        Worker second_worker(2, 1, 0, nullptr);
+        Worker third_worker(3, 2, 0, nullptr);
+        Worker new_worker(4, 0, 0, nullptr);
+        auto shared_membership{make_shared<SharedMembership>(vector<Worker*>{
+            &first_worker, &second_worker, &third_worker, &worker
+        })};
+        worker.set_membership(shared_membership);
+
+        shared_membership->remove(&second_worker);
+        shared_membership->insert(0, &new_worker);
+        shared_membership->remove(&third_worker);
+
+        CHECK(worker.get_direct_neighbour() == &new_worker);
+        CHECK(worker.position == 2);
+        CHECK(worker.membership->version == 3);
+    }
+}
+
+TEST_CASE(
+    "SharedMembership frees a version no Worker holds, while an older one is still held", 
+    "[worker]"
+) {
+    Worker first_worker(1, 0, 0, nullptr);
+    Worker second_worker(2, 1, 0, nullptr);
+    Worker third_worker(3, 2, 0, nullptr);
+    SharedMembership shared_membership{vector<Worker*>{
+        &first_worker, &second_worker, &third_worker
+    }};
+
+    // like a hung Worker, which never follows the changes
+    auto oldest_version{shared_membership.get()};
+
+    shared_membership.remove(&second_worker);
+    weak_ptr<const Membership> intermediate_version{shared_membership.get()};
+    shared_membership.insert(1, &second_worker);
+
+    CHECK(intermediate_version.expired());
+
+    vector<MembershipChange> changes{};
+    auto current_version{shared_membership.get_since(oldest_version->version, changes)};
+
+    CHECK(current_version->version == 2);
+    REQUIRE(changes.size() == 2);
+    CHECK_FALSE(changes[0].is_insertion);
+    CHECK(changes[0].worker == &second_worker);
+    CHECK(changes[1].is_insertion);
+    CHECK(changes[1].position == 1);
+}
+
+TEST_CASE(
+    "Worker stops at once while its Messages wait for a single-slot mailbox", 
+    "[worker][uses_message_buffer]"
+) {
+    // the neighbour doesn't run, so it never takes anything
+    Worker dummy_worker(100, 1, 0, nullptr);
+    // it sleeps after each Message, so request_stop finds its mailbox empty
+    Worker worker(1, 0, 100, nullptr);
+    worker.set_membership(
+        make_shared<SharedMembership>(vector<Worker*>{&worker, &dummy_worker})
+    );
+
+    thread worker_thread{ref(worker)};
+
+    // the first one fills the neighbour's mailbox, the others wait for space
+    for (int i{0}; i < 3; i++) {
+        worker.assign_message_and_wait(Message::election_proposal(50));
+    }
+    sleep();
+
+    auto start{chrono::steady_clock::now()};
+    worker.request_stop();
+    worker_thread.join();
+
+    // the sender would otherwise wait out the delivery waittime of 1 s
+    CHECK(chrono::steady_clock::now() - start < chrono::milliseconds(500));
+    // the Stop left in the mailbox would keep the Worker before it waiting
+    CHECK(worker.message_buffer.is_empty());
+}
+
+TEST_CASE(
+    "Worker sends what it couldn't assign to its dead neighbour to the new neighbour", 
+    "[worker][uses_message_buffer]"
+) {
+    // the neighbour doesn't run, so it dies with a delivery waittime of 1 s
+    Worker dead_worker(100, 1, 0, nullptr);
+    Worker next_worker(200, 2, 0, nullptr, WorkerOptions{8});
+    Worker worker(1, 0, 0, nullptr);
+    worker.set_membership(make_shared<SharedMembership>(
+        vector<Worker*>{&worker, &dead_worker, &next_worker}
+    ));
+
+    thread worker_thread{ref(worker)};
+
+    // the first one is assigned, but never taken, the second one times out 
+    // waiting for space and the others are still queued
+    for (unsigned int id{50}; id < 54; id++) {
+        worker.assign_message_and_wait(Message::election_proposal(id));
+    }
+    this_thread::sleep_for(chrono::milliseconds(1200));
+    // the failed deliveries are handled after the next Message
+    worker.assign_message_and_wait(Message::log_message("wake up"));
+    sleep();
+
+    worker.request_stop();
+    worker_thread.join();
+
+    set<unsigned int> proposed_ids{};
+    bool knows_dead_worker{false};
+    while (!next_worker.message_buffer.is_empty()) {
+        Message message{next_worker.message_buffer.take()};
+        if (message.type == MessageType::ElectionProposal) {
+            proposed_ids.insert(message.id);
+        }
+        knows_dead_worker = knows_dead_worker || message.type == MessageType::DeadWorker;
+    }
+
+    // the assigned one stays with the dead neighbour, which might only be slow
+    CHECK(proposed_ids == set<unsigned int>{51, 52, 53});
+    CHECK(knows_dead_worker);
+    CHECK(dead_worker.message_buffer.take().id == 50);
+}
+
+TEST_CASE(
+    "Worker of a hierarchical Ring takes on the id it stands in for in its own thread", 
+    "[worker][uses_message_buffer][worker_election]"
+) {
+    Worker dummy_worker(0, 1, 0, nullptr);
+    Worker worker(0, 0, 0, nullptr);
+    worker.set_membership(
+        make_shared<SharedMembership>(vector<Worker*>{&worker, &dummy_worker})
+    );
+    worker.set_election_handler([](unsigned int, uint16_t){});
+
+    thread worker_thread{ref(worker)};
+
+    worker.assign_message_and_wait(Message::stand_in(42, 3));
+    // a StandIn of an older election is dropped
+    worker.assign_message_and_wait(Message::stand_in(7, 2));
+    worker.assign_message_and_wait(Message::stop());
+    worker_thread.join();
+
+    CHECK(worker.election.id == 42);
+    CHECK(worker.election.epoch == 3);
+}
+
+TEST_CASE(
+    "Worker of a hierarchical Ring passes the leader of the level above around its ring once", 
+    "[worker][uses_message_buffer][worker_election]"
+) {
+    bool is_leader{GENERATE(true, false)};
+
+    Worker dummy_worker(0, 1, 0, nullptr);
+    Worker worker(5, 0, 0, nullptr);
+    worker.set_membership(
+        make_shared<SharedMembership>(vector<Worker*>{&worker, &dummy_worker})
+    );
+    worker.set_election_handler([](unsigned int, uint16_t){});
+    worker.election.is_leader = is_leader;
+
+    thread worker_thread{ref(worker)};
+
+    // the ring's leader learns about the leader above first, the others after it
+    worker.assign_message_and_wait(Message::elected(9));
+    sleep();
+
+    CHECK_FALSE(worker.election.is_leader);
+    REQUIRE_FALSE(dummy_worker.message_buffer.is_empty());
+    auto message{dummy_worker.message_buffer.take()};
+    CHECK(message.type == MessageType::Elected);
+    CHECK(message.id == 9);
+
+    // once it's gone around the ring, it isn't passed on anymore
+    worker.assign_message_and_wait(Message::elected(9));
+    worker.assign_message_and_wait(Message::stop());
+    worker_thread.join();
+
+    CHECK(dummy_worker.message_buffer.is_empty());
+}
+
+TEST_CASE(
+    "ElectionMessageCounter only counts the Messages of the newest epoch", 
+    "[worker]"
+) {
+    ElectionMessageCounter counter{};
+
+    counter.count(1);
+    counter.count(1);
+    counter.count(2);
+    // a late Message of the superseded election
+    counter.count(1);
+    counter.count(2);
+
+    CHECK(counter.take(1) == 0);
+    CHECK(counter.take(2) == 2);
+    CHECK(counter.take(2) == 0);
+
+    // the epochs wrap around
+    counter.count(30000);
+    counter.count(60000);
+    counter.count(0);
+    CHECK(counter.take(0) == 1);
 }
 
 #endif // UNIT_TEST
@@ -0,0 +1,123 @@
+#include "wire_format.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+// the size of an encoded number and of an encoded epoch
+constexpr size_t number_size{4};
+constexpr size_t epoch_size{2};
+// a longer content of a LogMessage is taken as corrupt,
+// so a peer can't make the decoder wait for gigabytes
+constexpr size_t max_content_size{64 * 1024};
+
+
+static void append_number(uint32_t number, vector<uint8_t>& bytes) {
+    for (size_t i{0}; i < number_size; i++) {
+        bytes.push_back((uint8_t)(number >> (8 * i)));
+    }
+}
+
+static void append_epoch(uint16_t epoch, vector<uint8_t>& bytes) {
+    bytes.push_back((uint8_t)epoch);
+    bytes.push_back((uint8_t)(epoch >> 8));
+}
+
+static uint16_t read_epoch(const uint8_t* bytes) {
+    return (uint16_t)(bytes[0] | bytes[1] << 8);
+}
+
+static uint32_t read_number(const uint8_t* bytes) {
+    uint32_t number{0};
+    for (size_t i{0}; i < number_size; i++) {
+        number |= (uint32_t)bytes[i] << (8 * i);
+    }
+
+    return number;
+}
+
+bool encode_message(const Message& message, vector<uint8_t>& bytes) {
+    switch (message.type) {
+        case MessageType::NoMessage:
+        case MessageType::Stop:
+            bytes.push_back((uint8_t)message.type);
+            return true;
+        case MessageType::StartElection:
+            bytes.push_back((uint8_t)message.type);
+            append_epoch(message.epoch, bytes);
+            return true;
+        case MessageType::ElectionProposal:
+        case MessageType::Elected:
+            bytes.push_back((uint8_t)message.type);
+            append_number(message.id, bytes);
+            append_epoch(message.epoch, bytes);
+            return true;
+        case MessageType::DeadWorker:
+            bytes.push_back((uint8_t)message.type);
+            append_number(message.position, bytes);
+            return true;
+        case MessageType::LogMessage:
+            if (message.content_size > max_content_size) {
+                return false;
+            }
+            bytes.push_back((uint8_t)message.type);
+            append_number(message.content_size, bytes);
+            bytes.insert(bytes.end(), message.content, message.content + message.content_size);
+            return true;
+        default:
+            return false;
+    }
+}
+
+size_t decode_message(const uint8_t* bytes, size_t number_of_bytes, Message& message) {
+    if (number_of_bytes == 0) {
+        return 0;
+    }
+
+    MessageType type{(MessageType)bytes[0]};
+    switch (type) {
+        case MessageType::NoMessage:
+        case MessageType::Stop:
+            message = Message{type};
+            return 1;
+        case MessageType::StartElection:
+            if (number_of_bytes < 1 + epoch_size) {
+                return 0;
+            }
+            message = Message::start_election(read_epoch(bytes + 1));
+            return 1 + epoch_size;
+        case MessageType::ElectionProposal:
+        case MessageType::Elected:
+            if (number_of_bytes < 1 + number_size + epoch_size) {
+                return 0;
+            }
+            message = Message{type};
+            message.id = read_number(bytes + 1);
+            message.epoch = read_epoch(bytes + 1 + number_size);
+            return 1 + number_size + epoch_size;
+        case MessageType::DeadWorker:
+            if (number_of_bytes < 1 + number_size) {
+                return 0;
+            }
+            message = Message{type};
+            message.position = read_number(bytes + 1);
+            return 1 + number_size;
+        case MessageType::LogMessage: {
+            if (number_of_bytes < 1 + number_size) {
+                return 0;
+            }
+            size_t content_size{read_number(bytes + 1)};
+            if (content_size > max_content_size) {
+                throw invalid_argument("The content of the LogMessage is too long.");
+            }
+            if (number_of_bytes < 1 + number_size + content_size) {
+                return 0;
+            }
+            const char* content{(const char*)bytes + 1 + number_size};
+            message = Message::log_message(string_view{content, content_size});
+            return 1 + number_size + content_size;
+        }
+        default:
+            throw invalid_argument("The bytes don't start with a known type of Message.");
+    }
+}
@@ -1,6 +1,9 @@
 #include "worker.h"
 #include "messages.h"
 #include "presenters/no_presenter.h"
+#include "shard.h"
+#include "futex.h"
+#include "placement.h"
 
 #include <spdlog/spdlog.h>
 #include <chrono>
@@ -11,34 +14,73 @@
 using namespace std;
 
 
-bool Worker::assign_message_and_wait(Message* message) {
-    // 1 worker sleeptime should be expected at least
-    // 2 because it might get a message from the Ring
-    // 2.5 because there are processes besides just sleeping
-    // The waittime is at least 1s.
-    return message_buffer.assign_and_wait(
-        message, 
-        max(1000u, (unsigned int)(sleeptime * 2.5))
-    );
+bool Worker::assign_message_and_wait(const Message& message) {
+    return message_buffer.assign_and_wait(message, get_delivery_waittime());
 }
 
-void Worker::assign_message(Message* message) {
+void Worker::assign_message(const Message& message) {
+    if (shard) {
+        shard->assign(this, message);
+        return;
+    }
+
     message_buffer.assign(message);
+
+    if (scheduler) {
+        schedule(sleeptime);
+    }
 }
 
-void Worker::set_neighbours(vector<Worker*> neighbours) {
-    if (neighbours.size() > 0) {
-        this->neighbours = neighbours;
+bool Worker::assign_message_until(
+    const Message& message, 
+    chrono::steady_clock::time_point deadline, 
+    DeliveryTicket& ticket
+) {
+    if (shard) {
+        // a Shard always has space for it
+        shard->assign(this, message);
+        ticket = 0;
+        return true;
+    }
+
+    bool is_assigned{message_buffer.assign_until(message, deadline, ticket)};
+
+    if (is_assigned && scheduler) {
+        schedule(sleeptime);
+    }
+
+    return is_assigned;
+}
+
+bool Worker::has_taken(DeliveryTicket ticket) {
+    return message_buffer.is_taken(ticket);
+}
+
+unsigned int Worker::get_delivery_waittime() const {
+    // 1 worker sleeptime per wakeup the messages queued ahead take,
+    //   a full mailbox takes capacity / batch limit wakeups
+    // 1 more because it might get a message from the Ring
+    // 0.5 more because there are processes besides just sleeping
+    // The waittime is at least 1s.
+    size_t wakeups_ahead{(message_buffer.get_capacity() + batch_limit - 1) / batch_limit};
+    return max(1000u, (unsigned int)(sleeptime * (wakeups_ahead + 1.5)));
+}
+
+void Worker::set_membership(shared_ptr<SharedMembership> shared_membership) {
+    if (shared_membership) {
+        this->shared_membership = move(shared_membership);
+        membership = this->shared_membership->get();
     }
     else {
-        throw invalid_argument("There must be at least on neighbour to which to send.");
+        throw invalid_argument("There must be a membership with a neighbour to which to send.");
     }
 }
 
 void Worker::set_presenter(Presenter* presenter) {
     // sets the presenter of the worker to the given presenter 
     // when it's not a null pointer,
-    // otherwise it's set to no presenter
+    // otherwise it's set to its own no presenter
+    owns_presenter = !presenter;
     this->presenter = 
         presenter
         ? presenter
@@ -49,215 +91,546 @@ bool Worker::is_running() const {
     return running;
 }
 
+const BatchStatistics& Worker::get_batch_statistics() const {
+    return batch_statistics;
+}
+
 Worker::~Worker() {
-    // if the presenter of the worker is no presenter it needs to be deleted
-    NoPresenter* no_presenter{dynamic_cast<NoPresenter*>(presenter)};
-    if (no_presenter) {
-        delete no_presenter;
+    // if the worker created its own no presenter it needs to be deleted
+    if (owns_presenter) {
+        delete presenter;
     }
 }
 
 void Worker::operator()() {
-    if (neighbours.size() > 0) {
+    if (membership) {
         running = true;
+        // before the sender thread is started, so it's pinned likewise
+        pin_current_thread(cpu);
+        outbox.start(sender_stack_size);
 
         bool continue_operation{true};
         while (continue_operation) {
-            this_thread::sleep_for(chrono::milliseconds(sleeptime));
-            continue_operation = act_upon_message(message_buffer.take());
+            sleep();
+            if (is_stop_requested()) {
+                break;
+            }
+
+            batch.clear();
+            batch_statistics.add_batch(
+                message_buffer.take_all(batch, batch_limit)
+            );
+            continue_operation = act_upon_messages(batch) && !is_stop_requested();
+
+            handle_failed_deliveries();
+        }
+
+        outbox.stop();
+        discard_mailbox();
+        running = false;
+    }
+}
+
+// Sleeps for the sleeptime, unless a stop is requested meanwhile
+void Worker::sleep() {
+    if (sleeptime == 0) {
+        return;
+    }
+
+    auto deadline{chrono::steady_clock::now() + chrono::milliseconds(sleeptime)};
+    auto now{chrono::steady_clock::now()};
+
+    while (stop_signal.load(memory_order_acquire) == 0 && now < deadline) {
+        futex_wait_for(stop_signal, 0, deadline - now);
+        now = chrono::steady_clock::now();
+    }
+}
+
+// What is left in the mailbox of a stopped Worker, like the Stop of request_stop,
+// would keep the sender of the Worker before it waiting for space.
+void Worker::discard_mailbox() {
+    batch.clear();
+    while (message_buffer.try_take_all(batch, message_buffer.get_capacity()) > 0) {
+        for (Message& message : batch) {
+            message.dispose();
+        }
+        batch.clear();
+    }
+}
+
+bool Worker::is_stop_requested() {
+    // pairs with the fence in request_stop, 
+    // so a Worker which took a Message that kept the Stop out sees the signal
+    atomic_thread_fence(memory_order_seq_cst);
+    return stop_signal.load(memory_order_relaxed) != 0;
+}
+
+void Worker::set_transport(Transport* transport) {
+    this->transport = transport;
+}
+
+void Worker::set_election_handler(function<void(unsigned int, uint16_t)> election_handler) {
+    this->election_handler = move(election_handler);
+}
+
+void Worker::set_completion_handler(function<void(unsigned int, uint16_t)> completion_handler) {
+    this->completion_handler = move(completion_handler);
+}
+
+void Worker::set_election_message_counter(ElectionMessageCounter* election_message_counter) {
+    this->election_message_counter = election_message_counter;
+}
+
+void Worker::set_cpu(int cpu) {
+    this->cpu = cpu;
+}
+
+void Worker::set_sender_stack_size(size_t stack_size) {
+    sender_stack_size = stack_size;
+}
+
+void Worker::request_stop() {
+    stop_signal.store(1, memory_order_release);
+    futex_wake_all(stop_signal);
+    atomic_thread_fence(memory_order_seq_cst);
+
+    // A Worker blocked on its empty mailbox is only woken by a Message.
+    // If the mailbox is full instead, the Worker isn't blocked
+    // and sees the signal after it has taken its Messages.
+    DeliveryTicket ticket;
+    message_buffer.assign_until(Message::stop(), chrono::steady_clock::now(), ticket);
+}
+
+void Worker::start_as_task(Scheduler* scheduler) {
+    if (membership) {
+        this->scheduler = scheduler;
+        running = true;
+        outbox.start_without_sender();
+     #ifdef WITH_COROUTINES
+        coroutine = live();
+     #endif
+
+        if (!message_buffer.is_empty()) {
+            schedule(0);
         }
+    }
+}
+
+void Worker::run() {
+    if (!running) {
+        return; // stays marked as scheduled, so it's never run again
+    }
+
+ #ifdef WITH_COROUTINES
+    coroutine.resume();
+ #else
+    batch.clear();
+    size_t number_of_messages{message_buffer.try_take_all(batch, batch_limit)};
+    bool continue_operation{true};
+    if (number_of_messages > 0) {
+        batch_statistics.add_batch(number_of_messages);
+        continue_operation = act_upon_messages(batch);
+    }
 
+    handle_failed_deliveries();
+
+    if (!continue_operation) {
+        outbox.stop();
         running = false;
+        return;
     }
+
+    bool has_queued_deliveries{outbox.flush()};
+
+    // Unmarked before checking the mailbox, 
+    // so a Message assigned in between schedules the Worker itself.
+    scheduled.exchange(false);
+    if (!message_buffer.is_empty()) {
+        schedule(sleeptime);
+    }
+    else if (has_queued_deliveries) {
+        schedule(1); // retry when the receivers might have space again
+    }
+ #endif
+}
+
+#ifdef WITH_COROUTINES
+// The counterpart of run() as a coroutine, which is suspended after every batch:
+// until the next Message while the mailbox is empty, 
+// for the sleeptime otherwise.
+WorkerCoroutine Worker::live() {
+    bool continue_operation{true};
+
+    while (true) {
+        batch.clear();
+        size_t number_of_messages{message_buffer.try_take_all(batch, batch_limit)};
+        if (number_of_messages > 0) {
+            batch_statistics.add_batch(number_of_messages);
+            continue_operation = act_upon_messages(batch);
+        }
+
+        handle_failed_deliveries();
+
+        if (!continue_operation) {
+            break;
+        }
+
+        co_await MailboxAwaiter{*this, outbox.flush()};
+    }
+
+    outbox.stop();
+    running = false;
+}
+
+// The Worker is always suspended or scheduled anew by await_suspend.
+bool Worker::MailboxAwaiter::await_ready() {
+    return false;
 }
 
-ContinueOperation Worker::act_upon_message(Message* message) {
+// Returns if the coroutine stays suspended.
+bool Worker::MailboxAwaiter::await_suspend(coroutine_handle<>) {
+    // Once the Worker is unmarked, the coroutine may be resumed elsewhere
+    // and the awaiter may be gone, so only locals are used from then on.
+    Worker& worker{this->worker};
+    bool has_queued_deliveries{this->has_queued_deliveries};
+
+    // Unmarked before checking the mailbox, 
+    // so a Message assigned in between schedules the Worker itself.
+    worker.scheduled.exchange(false);
+    if (!worker.message_buffer.is_empty()) {
+        if (worker.scheduled.exchange(true)) {
+            return true; // it has been scheduled by the assignment
+        }
+        if (worker.sleeptime == 0) {
+            return false; // continues right away
+        }
+        worker.scheduler->schedule_after(&worker, worker.sleeptime);
+    }
+    else if (has_queued_deliveries) {
+        worker.schedule(1); // retry when the receivers might have space again
+    }
+
+    return true;
+}
+#endif
+
+// Schedules the Worker as a Task after the delay in milliseconds,
+// unless it's already scheduled.
+void Worker::schedule(unsigned int delay) {
+    if (!scheduled.exchange(true)) {
+        scheduler->schedule_after(this, delay);
+    }
+}
+
+ContinueOperation Worker::act_upon_messages(vector<Message>& messages) {
+    for (auto it{messages.begin()}; it < messages.end(); it++) {
+        if (!act_upon_message(*it)) {
+            // the remaining Messages won't be handled anymore
+            for (it++; it < messages.end(); it++) {
+                it->dispose();
+            }
+            return false;
+        }
+    }
+
+    return true;
+}
+
+ContinueOperation Worker::act_upon_message(Message& message) {
     ContinueOperation continue_operation{true};
 
-    presenter->worker_got_message(id, message);
+    presenter->worker_got_message(election.id, message);
 
-    switch (message->type) {
+    if (!enter_epoch(election, message)) {
+        presenter->worker_drops_stale_message(election.id, message);
+        message.dispose();
+        return continue_operation;
+    }
+
+    switch (message.type) {
         case MessageType::LogMessage:
-            presenter->worker_says(id, message->cast_to<LogMessage>()->content);
+            presenter->worker_says(election.id, message.get_content());
             break;
         case MessageType::StartElection:
-            start_election();
-            break;
         case MessageType::ElectionProposal:
-            participate_in_election(message->cast_to<ElectionProposal>());
-            break;
         case MessageType::Elected:
-            end_election(message->cast_to<Elected>());
+        case MessageType::Probe:
+        case MessageType::Reply:
+        case MessageType::Candidate:
+        case MessageType::PreviousCandidate:
+            act_upon_election_message(election, message);
+            break;
+        case MessageType::StandIn:
+            // the Worker's own thread takes on the id, once the epoch is entered
+            election.id = message.id;
             break;
         case MessageType::Stop:
             continue_operation = false;
             break;
         case MessageType::DeadWorker:
-            handle_dead_worker(message->cast_to<DeadWorker>());
+            handle_dead_worker(message);
             break;
         case MessageType::NewWorker:
-            add_new_worker(message->cast_to<NewWorker>());
+            add_new_worker(message);
             break;
         case MessageType::NoMessage:
             break;
     }
 
-    delete message;
+    message.dispose();
 
     return continue_operation;
 }
 
-void Worker::start_election() {
-    presenter->worker_starts_election(id);
-
-    presenter->worker_participates_in_election(id);
-    participates_in_election = true;
+// Without a hierarchical Ring or a Ring to complete it,
+// the leader reports the election itself.
+void Worker::finish_election(ElectionState& node) {
+    if (election_handler) {
+        election_handler(node.id, node.epoch);
+    }
+    else if (completion_handler) {
+        completion_handler(node.id, node.epoch);
+    }
+    else {
+        report_election_messages();
+        presenter->election_is_finished(node.id);
+    }
+}
 
-    propose_oneself();
+bool Worker::has_level_above() const {
+    return (bool)election_handler;
 }
 
-void Worker::participate_in_election(ElectionProposal* proposal) {
-    if (is_leader) {
-        presenter->worker_resigns_as_leader(id);
-        is_leader = false;
+void Worker::report_election_messages() {
+    if (election_message_counter) {
+        presenter->election_messages_counted(
+            to_string(election_algorithm), 
+            election_message_counter->take(election.epoch)
+        );
     }
+}
 
-    bool already_participated_in_election{participates_in_election};
+void Worker::handle_dead_worker(const Message& dead_worker) {
+    refresh_membership();
 
-    if (!participates_in_election) {
-        participates_in_election = true;
-        presenter->worker_participates_in_election(id);
+    if (dead_worker.position % membership->size() 
+            != 
+        get_direct_neighbour_position()
+    ) {
+        presenter->worker_removes_neighbour(election.id, dead_worker.position);
+        send_to_neighbour(dead_worker);
     }
+    // When the position is its neighbour's, 
+    // the Message has gone around the whole Ring,
+    // because only the preceding neighbour can know if a worker is dead 
+    // and must therefore be the first to recognize and remove it.
+}
 
-    if (proposal->id > id) {
-        forward_election_proposal(proposal);
-    }
-    else if (proposal->id == id) {
-        be_elected();
-    }
-    else {
-        if (already_participated_in_election) {
-            presenter->worker_discards_election_proposal(id, proposal->id);
-        }
-        else {
-            propose_oneself();
+void Worker::add_new_worker(const Message& new_worker) {
+    if (new_worker.worker != this) {
+        refresh_membership();
+
+        // the first Worker to learn about the new worker inserts it for all
+        if (membership->at(new_worker.position) != new_worker.worker) {
+            shared_membership->insert(new_worker.position, new_worker.worker);
+            refresh_membership();
         }
+
+        presenter->worker_adds_neighbour(election.id, new_worker.position);
+        send_to_neighbour(new_worker);
     }
+    // If the new worker is the worker itself, 
+    // the Message has gone around the whole Ring 
+    // and there is nothing left to do
 }
 
-void Worker::forward_election_proposal(ElectionProposal* proposal) {
-    presenter->worker_forwards_election_proposal(id, proposal->id);
-    send_to_neighbour(new ElectionProposal(*proposal));
-}
+void Worker::send_to_neighbour(const Message& message) {
+    if (transport && get_direct_neighbour_position() == 0 && !transport->has_lost_next()) {
+        Message sent_message{message};
+        if (is_election_message(message)) {
+            sent_message.epoch = election.epoch;
+        }
+        transport->send(sent_message);
+        return;
+    }
 
-void Worker::be_elected() {
-    presenter->worker_is_elected(id);
-    is_leader = true;
+    send_to(get_direct_neighbour(), message);
+}
 
-    presenter->worker_stops_election_participation(id);
-    participates_in_election = false;
+void Worker::send_to_neighbour_of(ElectionState&, const Message& message) {
+    send_to_neighbour(message);
+}
 
-    send_to_neighbour(new Elected(id));
+// Only a Hirschberg-Sinclair election sends against the direction of the Ring.
+void Worker::send_to_predecessor(const Message& message) {
+    send_to(get_predecessor(), message);
 }
 
-void Worker::propose_oneself() {
-    presenter->worker_proposes_itself_in_election(id);
-    send_to_neighbour(new ElectionProposal(id));
+void Worker::send_to_predecessor_of(ElectionState&, const Message& message) {
+    send_to_predecessor(message);
 }
 
-void Worker::end_election(Elected* elected) {
-    if (elected->id == id) {
-        presenter->election_is_finished(id);
+// The Messages of an election are sent in the Worker's epoch.
+void Worker::send_to(Worker* receiver, const Message& message) {
+    Message sent_message{message};
+    if (is_election_message(message)) {
+        sent_message.epoch = election.epoch;
+
+        if (election_message_counter) {
+            election_message_counter->count(election.epoch);
+        }
     }
-    else {
-        presenter->worker_stops_election_participation(id);
-        participates_in_election = false;
 
-        send_to_neighbour(new Elected(elected->id));
+    if (shard) {
+        shard->send(this, receiver, sent_message);
+        return;
     }
+
+    handle_failed_deliveries();
+
+    outbox.send(receiver, sent_message);
 }
 
-void Worker::handle_dead_worker(DeadWorker* dead_worker) {
-    if (dead_worker->position != get_direct_neighbour_position()) {
-        remove_dead_worker(dead_worker->position);
-    }
-    // When the position is its neighbour, 
-    // the dead worker has been already removed, 
-    // because only the preceding neighbour can know if a worker is dead 
-    // and must therefore be the first to recognize and remove it.
+void Worker::handle_failed_deliveries() {
+    handle_failed_deliveries(outbox.take_failed_receivers());
+    handle_lost_segment();
 }
 
-void Worker::add_new_worker(NewWorker* new_worker) {
-    unsigned int new_neighbour_index{
-        get_neighbours_index_for_position(new_worker->position)
-    };
+void Worker::handle_failed_deliveries(const vector<Worker*>& failed_receivers) {
+    for (Worker* receiver : failed_receivers) {
+        if (receiver == get_direct_neighbour()) {
+            // a message still hasn't been retrieved by the neighbour,
+            // neighbour is considered dead
+            unsigned int neighbour_position{get_direct_neighbour_position()};
+            presenter->worker_recognizes_dead_neighbour(election.id, neighbour_position);
+            remove_dead_neighbour(receiver, neighbour_position);
+        }
+        // Otherwise the receiver has already been removed 
+        // because of an earlier failed delivery.
+    }
+}
 
-    if (*neighbours[new_neighbour_index] != *new_worker->worker) {
-        presenter->worker_adds_neighbour(id, new_worker->position);
+// The next segment of a Ring spread over processes, which has been lost,
+// is removed by the Worker before the first position like a dead neighbour,
+// so the segment closes into a Ring of its own, until the next segment is back.
+void Worker::handle_lost_segment() {
+    if (!transport || get_direct_neighbour_position() != 0) {
+        return;
+    }
 
-        neighbours.insert(
-            neighbours.begin() + new_neighbour_index, 
-            new_worker->worker
-        );
+    vector<Message> unsent_messages{};
+    if (!transport->take_lost_next(unsent_messages)) {
+        return;
+    }
 
-        if (new_worker->position <= position) {
-            position++; // update position when necessary
-        }
+    presenter->worker_recognizes_dead_neighbour(election.id, 0);
+    presenter->worker_removes_neighbour(election.id, 0);
 
-        send_to_neighbour(new NewWorker(*new_worker));
+    // what the next segment didn't get goes to the first Worker instead
+    for (const Message& message : unsent_messages) {
+        send_to(get_direct_neighbour(), message);
     }
-    // If the new worker and the neighbour at the index for the new worker 
-    // are the same, the new worker has already been inserted 
-    // and there is nothing left to do
+    send_to(get_direct_neighbour(), Message::dead_worker(0));
 }
 
-void Worker::send_to_neighbour(Message* message) {
-    if (previous_message_sent.valid() && !previous_message_sent.get()) {
-        // previous message still hasn't been retrieved by neighbour,
-        // neighbour is considered dead
-        unsigned int neighbour_position{get_direct_neighbour_position()};
-        presenter->worker_recognizes_dead_neighbour(id, neighbour_position);
-        remove_dead_worker(neighbour_position);
-    }
+void Worker::remove_dead_neighbour(Worker* neighbour, unsigned int position) {
+    presenter->worker_removes_neighbour(election.id, position);
 
-    previous_message_sent = async(
-        [message{message}, this](){ 
-            return neighbours[0]->assign_message_and_wait(message); 
-        }
-    );
+    shared_membership->remove(neighbour);
+    refresh_membership();
+
+    // what there was no space for at the dead neighbour goes to the new one
+    outbox.redirect(neighbour, get_direct_neighbour());
+    send_to_neighbour(Message::dead_worker(position));
 }
 
-void Worker::remove_dead_worker(unsigned int position) {
-    presenter->worker_removes_neighbour(id, position);
+// Follows the changes of the shared Membership up to its current version
+// and updates the position according to each of them.
+void Worker::refresh_membership() {
+    if (membership->version == shared_membership->get_version()) {
+        return;
+    }
 
-    neighbours.erase(
-        neighbours.begin() 
-            + 
-        get_neighbours_index_for_position(position)
-    );
+    vector<MembershipChange> changes{};
+    membership = shared_membership->get_since(membership->version, changes);
 
-    if (position < this->position) {
-        this->position--; // update position when necessary
+    for (const MembershipChange& change : changes) {
+        if (change.is_insertion) {
+            if (change.position <= position && change.worker != this) {
+                position++;
+            }
+        }
+        else if (change.position < position) {
+            position--;
+        }
     }
+}
+
+Worker* Worker::get_direct_neighbour() {
+    refresh_membership();
+    return membership->at(position + 1);
+}
 
-    send_to_neighbour(new DeadWorker(position));
+Worker* Worker::get_predecessor() {
+    refresh_membership();
+    return membership->at(position + membership->size() - 1);
 }
 
 unsigned int Worker::get_direct_neighbour_position() {
-    return (position + 1) % neighbours.size();
+    return (position + 1) % membership->size();
 }
 
-unsigned int Worker::get_neighbours_index_for_position(unsigned int position) {
-    if (position > this->position) {
-        return position - this->position - 1;
-    }
-    else {
-        return position - this->position - 1 + neighbours.size();
-    }
+constexpr uint64_t election_message_count_mask{(uint64_t{1} << 48) - 1};
+
+void ElectionMessageCounter::count(uint16_t epoch) {
+    uint64_t current{epoch_and_count.load(memory_order_relaxed)};
+    uint64_t counted;
+    do {
+        uint16_t counted_epoch{(uint16_t)(current >> 48)};
+        if (counted_epoch == epoch) {
+            counted = current + 1;
+        }
+        else if (is_older_epoch(epoch, counted_epoch)) {
+            return;
+        }
+        else {
+            counted = ((uint64_t)epoch << 48) | 1;
+        }
+    } while (!epoch_and_count.compare_exchange_weak(current, counted, memory_order_relaxed));
+}
+
+size_t ElectionMessageCounter::take(uint16_t epoch) {
+    uint64_t current{epoch_and_count.load(memory_order_relaxed)};
+    do {
+        uint16_t counted_epoch{(uint16_t)(current >> 48)};
+        if (counted_epoch != epoch) {
+            return 0;
+        }
+    } while (!epoch_and_count.compare_exchange_weak(
+        current, 
+        (uint64_t)epoch << 48, 
+        memory_order_relaxed
+    ));
+
+    return current & election_message_count_mask;
+}
+
+void BatchStatistics::add_batch(size_t batch_size) {
+    number_of_batches++;
+    number_of_messages += batch_size;
+    largest_batch = max(largest_batch, batch_size);
+}
+
+BatchStatistics& BatchStatistics::operator+=(const BatchStatistics& other) {
+    number_of_batches += other.number_of_batches;
+    number_of_messages += other.number_of_messages;
+    largest_batch = max(largest_batch, other.largest_batch);
+
+    return *this;
 }
 
 bool Worker::operator==(const Worker& other_worker) {
-    return id == other_worker.id;
+    return election.id == other_worker.election.id;
 }
 
 bool Worker::operator!=(const Worker& other_worker) {